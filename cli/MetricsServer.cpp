@@ -0,0 +1,120 @@
+// cli/MetricsServer.cpp
+// AutomaticMacroMaker - localhost-only HTTP endpoint serving a MetricsRegistry
+// Developer: entity12208
+
+#include "MetricsServer.hpp"
+
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+static void closeSocket(SocketHandle s) { closesocket(s); }
+static int pollSocket(SocketHandle s, int ms) {
+    WSAPOLLFD p{s, POLLIN, 0};
+    return WSAPoll(&p, 1, ms);
+}
+static void setTimeouts(SocketHandle s, int ms) {
+    DWORD t = (DWORD)ms;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&t, sizeof(t));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&t, sizeof(t));
+}
+static constexpr int SEND_FLAGS = 0;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+using SocketHandle = int;
+static void closeSocket(SocketHandle s) { close(s); }
+static int pollSocket(SocketHandle s, int ms) {
+    pollfd p{s, POLLIN, 0};
+    return poll(&p, 1, ms);
+}
+static void setTimeouts(SocketHandle s, int ms) {
+    timeval t{ms / 1000, (ms % 1000) * 1000};
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &t, sizeof(t));
+#ifdef SO_NOSIGPIPE
+    int yes = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+}
+// A scraper that hangs up mid-response must not raise SIGPIPE and end the bench run.
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0; // SO_NOSIGPIPE instead, in setTimeouts
+#endif
+#endif
+
+namespace amm {
+
+// How often the accept loop checks for stop().
+static constexpr int POLL_MS = 200;
+// How long one client may take to send its request or take the response.
+static constexpr int CLIENT_TIMEOUT_MS = 1000;
+
+bool MetricsServer::start(int port) {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == (SocketHandle)-1) return false;
+    int yes = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 4) != 0) {
+        closeSocket(s);
+        return false;
+    }
+    m_socket = (intptr_t)s;
+    m_stop = false;
+    m_thread = std::thread([this]() { serve(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!m_thread.joinable()) return;
+    m_stop = true;
+    m_thread.join();
+    closeSocket((SocketHandle)m_socket);
+    m_socket = -1;
+}
+
+void MetricsServer::serve() {
+    SocketHandle listener = (SocketHandle)m_socket;
+    while (!m_stop) {
+        if (pollSocket(listener, POLL_MS) <= 0) continue;
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == (SocketHandle)-1) continue;
+        setTimeouts(client, CLIENT_TIMEOUT_MS);
+
+        // The request itself does not matter; read what has arrived and answer.
+        char buf[1024];
+        if (pollSocket(client, POLL_MS) > 0) recv(client, buf, sizeof(buf), 0);
+        std::string body = m_registry.exposition();
+        std::string response = "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            int n = (int)send(client, response.data() + sent, (int)(response.size() - sent), SEND_FLAGS);
+            if (n <= 0) break;
+            sent += (size_t)n;
+        }
+        closeSocket(client);
+    }
+}
+
+} // namespace amm
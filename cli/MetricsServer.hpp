@@ -0,0 +1,37 @@
+// cli/MetricsServer.hpp
+// AutomaticMacroMaker - localhost-only HTTP endpoint serving a MetricsRegistry
+// Developer: entity12208
+//
+// Just enough HTTP for a Prometheus scrape or curl: every request, whatever its path,
+// gets the current exposition text. Binds to 127.0.0.1 only, so nothing outside the
+// machine can reach it. Runs on its own thread until stop() or destruction.
+
+#pragma once
+
+#include "Metrics.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace amm {
+
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsRegistry& registry) : m_registry(registry) {}
+    ~MetricsServer() { stop(); }
+
+    // False if the socket cannot be bound (port in use, no permission).
+    bool start(int port);
+    void stop();
+
+private:
+    void serve();
+
+    const MetricsRegistry& m_registry;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+    intptr_t m_socket = -1;
+};
+
+} // namespace amm
@@ -0,0 +1,683 @@
+// cli/main.cpp
+// AutomaticMacroMaker - headless command line tool for the engine-free solver core
+// Developer: entity12208
+//
+// Built instead of the mod with -DAMM_HEADLESS=ON. Works on the corpus files the mod
+// dumps (see SnapshotIO.hpp), so anything that needs many levels or a lot of time
+// (training, benchmarks) can run outside the game.
+//
+//   macromaker-cli info <file.amms | archive.ammp --level NAME>
+//   macromaker-cli train <corpus> <model-out> [--horizon N] [--stride N] [--epochs N] [--seed N]
+//   macromaker-cli solve <file.amms | archive.ammp --level NAME> [--strategy NAME] [--timeout-ms N] [--robust]
+//   macromaker-cli bench <corpus> [--strategy NAME|all] [--timeout-ms N] [--robust]
+//                        [--jobs N] [--memory-mb N] [--metrics-port N]
+//   macromaker-cli golden <corpus> <baseline> [--strategy NAME] [--tolerance PCT] [--update]
+//   macromaker-cli pack <corpus-dir> <archive.ammp>
+//   macromaker-cli strategies
+//
+// A <corpus> is a directory of .amms files or a packed archive (CorpusArchive.hpp).
+
+#include "BatchQueue.hpp"
+#include "BoxMerge.hpp"
+#include "CollisionMemo.hpp"
+#include "Feasibility.hpp"
+#include "Collision.hpp"
+#include "CorpusArchive.hpp"
+#include "HazardRaster.hpp"
+#include "Metrics.hpp"
+#include "MetricsServer.hpp"
+#include "Physics.hpp"
+#include "SnapshotIO.hpp"
+#include "Strategy.hpp"
+#include "TreeEstimate.hpp"
+#include "ValueModel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static constexpr float SIM_DT = 1.0f / 60.0f;
+static constexpr int DEFAULT_TIMEOUT_MS = 40 * 1000; // same as the mod
+static constexpr uint64_t STEP_BUDGET = 50000;
+
+static int usage() {
+    std::fprintf(stderr,
+        "usage: macromaker-cli <command> [args]\n"
+        "  info <entry>                     print what a corpus entry contains\n"
+        "  train <corpus> <model-out>       fit the value model on every corpus entry\n"
+        "        [--horizon N] [--stride N] [--epochs N] [--seed N]\n"
+        "  solve <entry>                    run a solver strategy on one corpus entry\n"
+        "        [--strategy NAME] [--timeout-ms N] [--robust] [--no-scan]\n"
+        "  bench <corpus>                   run strategies on every corpus entry and compare them\n"
+        "        [--strategy NAME|all] [--timeout-ms N] [--robust] [--jobs N] [--memory-mb N]\n"
+        "        [--metrics-port N]   serve live metrics on 127.0.0.1:N while it runs\n"
+        "  golden <corpus> <baseline>       compare time, work and memory per level against a baseline\n"
+        "        [--strategy NAME] [--timeout-ms N] [--tolerance PCT] [--update]\n"
+        "  pack <corpus-dir> <archive>      pack a directory of .amms files into one .ammp archive\n"
+        "  strategies                       list the solver strategies\n"
+        "<corpus> is a directory of .amms files or an .ammp archive; <entry> is a .amms file,\n"
+        "or an archive followed by --level NAME.\n");
+    return 2;
+}
+
+// Value of `--name N` in argv[from..], or `fallback`.
+static int intOption(int argc, char** argv, int from, const char* name, int fallback) {
+    for (int i = from; i + 1 < argc; ++i)
+        if (std::strcmp(argv[i], name) == 0) return std::atoi(argv[i + 1]);
+    return fallback;
+}
+
+// Value of `--name S` in argv[from..], or `fallback`.
+static std::string stringOption(int argc, char** argv, int from, const char* name, const char* fallback) {
+    for (int i = from; i + 1 < argc; ++i)
+        if (std::strcmp(argv[i], name) == 0) return argv[i + 1];
+    return fallback;
+}
+
+static bool flag(int argc, char** argv, int from, const char* name) {
+    for (int i = from; i < argc; ++i)
+        if (std::strcmp(argv[i], name) == 0) return true;
+    return false;
+}
+
+static std::vector<fs::path> corpusFiles(const fs::path& dir) {
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& e : fs::directory_iterator(dir, ec))
+        if (e.is_regular_file() && e.path().extension() == amm::CORPUS_EXTENSION) files.push_back(e.path());
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static bool isArchive(const fs::path& path) {
+    return path.extension() == amm::CORPUS_ARCHIVE_EXTENSION;
+}
+
+// The entries of a corpus directory or archive, by name (the .amms file name).
+class Corpus {
+public:
+    bool open(const fs::path& path) {
+        m_packed = isArchive(path);
+        if (m_packed) return m_archive.open(path);
+        m_files = corpusFiles(path);
+        return true;
+    }
+    size_t size() const { return m_packed ? m_archive.size() : m_files.size(); }
+    std::string name(size_t i) const {
+        return m_packed ? std::string(m_archive.name(i)) : m_files[i].filename().string();
+    }
+    bool load(size_t i, amm::CorpusEntry& entry) const {
+        return m_packed ? m_archive.load(i, entry) : amm::loadCorpusEntry(m_files[i], entry);
+    }
+
+private:
+    bool m_packed = false;
+    std::vector<fs::path> m_files;
+    amm::CorpusArchive m_archive;
+};
+
+// One entry: a .amms file, or the entry `--level NAME` of an archive.
+static bool loadEntry(const fs::path& path, int argc, char** argv, int from, amm::CorpusEntry& entry) {
+    if (!isArchive(path)) return amm::loadCorpusEntry(path, entry);
+    std::string level = stringOption(argc, argv, from, "--level", "");
+    amm::CorpusArchive archive;
+    if (!archive.open(path)) return false;
+    size_t i = archive.find(level);
+    return i < archive.size() && archive.load(i, entry);
+}
+
+static int cmdInfo(const fs::path& path, int argc, char** argv) {
+    amm::CorpusEntry entry;
+    if (!loadEntry(path, argc, argv, 3, entry)) {
+        std::fprintf(stderr, "cannot read %s\n", path.string().c_str());
+        return 1;
+    }
+    const amm::LevelSnapshot& l = entry.level;
+    std::string name = isArchive(path) ? stringOption(argc, argv, 3, "--level", "") : path.filename().string();
+    std::printf("%s: %zu shapes (%zu boxes, %zu oriented, %zu triangles, %zu circles), %zu sections\n",
+        name.c_str(), l.shapeCount(), l.boxes.size(), l.orientedBoxes.size(),
+        l.triangles.size(), l.circles.size(), l.sections.size());
+    std::printf("  x %.1f -> %.1f, start y %.1f\n", l.startX, l.endX, l.startY);
+    amm::BoxSet boxes = l.boxes;
+    amm::BoxMergeStats merge;
+    amm::mergeBoxes(boxes, {}, &merge);
+    std::printf("  %zu boxes after merging adjacent blocks\n", merge.after);
+    std::printf("  %s, %zu ticks\n", entry.solved ? "solved" : "unsolved", entry.solution.size());
+    return 0;
+}
+
+static int cmdTrain(const fs::path& dir, const fs::path& out, int argc, char** argv) {
+    int horizon = intOption(argc, argv, 4, "--horizon", 30);
+    int stride = std::max(1, intOption(argc, argv, 4, "--stride", 20));
+    int epochs = intOption(argc, argv, 4, "--epochs", 20);
+    uint32_t seed = (uint32_t)intOption(argc, argv, 4, "--seed", 1);
+
+    std::vector<amm::TrainingSample> samples;
+    Corpus corpus;
+    if (!corpus.open(dir)) {
+        std::fprintf(stderr, "cannot open %s\n", dir.string().c_str());
+        return 1;
+    }
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        amm::CorpusEntry entry;
+        if (!corpus.load(i, entry)) {
+            std::fprintf(stderr, "skipping %s (unreadable)\n", corpus.name(i).c_str());
+            continue;
+        }
+        amm::Broadphase broadphase;
+        broadphase.build(entry.level);
+        amm::HazardRaster raster;
+        raster.build(entry.level);
+        size_t before = samples.size();
+        amm::collectSamples(entry.level, broadphase, raster, entry.solution, horizon, stride, SIM_DT,
+            seed + (uint32_t)i, samples);
+        std::printf("%s: %zu samples\n", corpus.name(i).c_str(), samples.size() - before);
+    }
+    if (samples.empty()) {
+        std::fprintf(stderr, "no samples: %s has no usable corpus entries\n", dir.string().c_str());
+        return 1;
+    }
+
+    size_t total = samples.size(), positives = 0;
+    for (const auto& s : samples) positives += s.label > 0.5f;
+    amm::ValueModel model;
+    float loss = model.fit(std::move(samples), epochs, 0.05f, seed);
+    if (!model.save(out)) {
+        std::fprintf(stderr, "cannot write %s\n", out.string().c_str());
+        return 1;
+    }
+    std::printf("trained on %zu states (%zu survived), log loss %.4f -> %s\n",
+        total, positives, loss, out.string().c_str());
+    return 0;
+}
+
+struct StrategyRun {
+    bool solved = false;
+    size_t ticks = 0;
+    double ms = 0.0;
+    uint64_t work = 0;
+    size_t peakMemory = 0; // largest SolveProgress::memory seen
+    std::string report;
+};
+
+// Drives one strategy the way the mod does, without the value model or bit-state set.
+// `onStep` runs after every step and, inside long tick searches, whenever the tree
+// estimator has news; the work of the running search is in the estimator then.
+static StrategyRun runStrategy(const amm::StrategyInfo& info, const amm::LevelSnapshot& level,
+                               const amm::Broadphase& broadphase, int timeoutMs, bool robust,
+                               const std::function<void(const amm::SolveProgress&, const amm::TreeEstimator&)>&
+                                   onStep = {}) {
+    auto start = std::chrono::steady_clock::now();
+    amm::TreeEstimator estimator;
+    amm::SolveContext ctx;
+    ctx.level = &level;
+    ctx.broadphase = &broadphase;
+    ctx.settings.dt = SIM_DT;
+    ctx.settings.robust = robust;
+    ctx.settings.estimator = &estimator;
+    ctx.deadline.at = start + std::chrono::milliseconds(timeoutMs);
+
+    auto strategy = info.create();
+    strategy->prepare(ctx);
+    if (onStep) estimator.setListener([&]() { onStep(strategy->progress(), estimator); });
+    StrategyRun run;
+    bool more = true;
+    while (more) {
+        more = strategy->step(STEP_BUDGET);
+        amm::SolveProgress progress = strategy->progress();
+        run.peakMemory = std::max(run.peakMemory, progress.memory);
+        if (onStep) onStep(progress, estimator);
+    }
+    auto solutions = strategy->extract();
+
+    run.solved = !solutions.empty();
+    if (run.solved) run.ticks = solutions.front().size();
+    run.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    run.work = strategy->progress().work;
+    run.report = strategy->report();
+    return run;
+}
+
+static size_t snapshotBytes(const amm::LevelSnapshot& l) {
+    return l.boxes.size() * (4 * sizeof(float) + 1) + l.orientedBoxes.size() * (6 * sizeof(float) + 1) +
+        l.triangles.size() * (6 * sizeof(float) + 1) + l.circles.size() * (3 * sizeof(float) + 1) +
+        l.sections.size() * sizeof(amm::Section);
+}
+
+static size_t broadphaseBytes(const amm::Broadphase& bp) {
+    return (bp.columnCount() + 1 + bp.entryCount()) * sizeof(uint32_t) + bp.memo().bytes();
+}
+
+// What `bench --metrics-port` exposes (Metrics.hpp). Per-worker values are labelled
+// with the worker index; the rest are totals over all workers.
+struct BenchMetrics {
+    struct Worker {
+        amm::Gauge& workPerSecond;
+        amm::Gauge& cacheEntries;
+        amm::Gauge& estimatedWork;
+        amm::Gauge& explored;
+        amm::Gauge& etaSeconds;
+    };
+
+    amm::MetricsRegistry registry;
+    amm::Gauge& inFlight = registry.gauge("amm_solves_in_flight", "Solves currently running.");
+    amm::Gauge& queueDepth = registry.gauge("amm_queue_depth", "Solves waiting in the batch queue.");
+    amm::Counter& solved = registry.counter("amm_solves_total", "Finished solves.", "result=\"solved\"");
+    amm::Counter& failed = registry.counter("amm_solves_total", "Finished solves.", "result=\"failed\"");
+    amm::Counter& work = registry.counter("amm_work_units_total",
+        "Solver work units (physics steps, graph nodes, grid cells) over all workers.");
+    amm::Gauge& snapshotBytes = registry.gauge("amm_memory_bytes", "Approximate memory in use.",
+        "subsystem=\"snapshot\"");
+    amm::Gauge& broadphaseBytes = registry.gauge("amm_memory_bytes", "Approximate memory in use.",
+        "subsystem=\"broadphase\"");
+    amm::Gauge& searchBytes = registry.gauge("amm_memory_bytes", "Approximate memory in use.",
+        "subsystem=\"search\"");
+    amm::Histogram& latency = registry.histogram("amm_solve_seconds", "Wall time per solve.",
+        {0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 20, 40, 80});
+    std::vector<Worker> workers;
+
+    explicit BenchMetrics(int count) {
+        for (int w = 0; w < count; ++w) {
+            std::string label = "worker=\"" + std::to_string(w) + "\"";
+            workers.push_back({
+                registry.gauge("amm_worker_work_units_per_second", "Work units per second over the last step.", label),
+                registry.gauge("amm_worker_cache_entries", "Entries in the strategy's transposition / section cache.",
+                    label),
+                registry.gauge("amm_worker_estimated_work_units",
+                    "Predicted total work units of the running solve (TreeEstimate.hpp), 0 if unknown.", label),
+                registry.gauge("amm_worker_explored_ratio", "Share of the predicted work already done.", label),
+                registry.gauge("amm_worker_eta_seconds",
+                    "Predicted seconds left in the running solve at its rate so far, -1 if unknown.", label)});
+        }
+    }
+};
+
+// The strategies named by --strategy: one, or every registered one for "all".
+static std::vector<const amm::StrategyInfo*> pickStrategies(const std::string& name) {
+    std::vector<const amm::StrategyInfo*> picked;
+    for (const auto& s : amm::strategies())
+        if (name == "all" || s.name == name) picked.push_back(&s);
+    if (picked.empty()) std::fprintf(stderr, "unknown strategy %s (see macromaker-cli strategies)\n", name.c_str());
+    return picked;
+}
+
+static int cmdStrategies() {
+    for (const auto& s : amm::strategies()) std::printf("%-10s %s\n", s.name.c_str(), s.description.c_str());
+    return 0;
+}
+
+static int cmdSolve(const fs::path& path, int argc, char** argv) {
+    auto picked = pickStrategies(stringOption(argc, argv, 3, "--strategy", amm::strategies().front().name.c_str()));
+    if (picked.empty()) return 2;
+    amm::CorpusEntry entry;
+    if (!loadEntry(path, argc, argv, 3, entry)) {
+        std::fprintf(stderr, "cannot read %s\n", path.string().c_str());
+        return 1;
+    }
+    amm::Broadphase broadphase;
+    broadphase.build(entry.level);
+    int timeoutMs = intOption(argc, argv, 3, "--timeout-ms", DEFAULT_TIMEOUT_MS);
+    bool robust = flag(argc, argv, 3, "--robust");
+
+    // Like the mod, skip the search when the level provably cannot be finished.
+    if (!flag(argc, argv, 3, "--no-scan")) {
+        auto start = std::chrono::steady_clock::now();
+        amm::Feasibility scan = amm::scanFeasibility(entry.level, broadphase, SIM_DT);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!scan.feasible) {
+            std::printf("infeasible at x %.1f: %s (%zu ticks scanned in %.1f ms)\n", scan.x, scan.reason.c_str(),
+                scan.ticks, ms);
+            return 1;
+        }
+    }
+
+    bool any = false;
+    for (const auto* info : picked) {
+        StrategyRun run = runStrategy(*info, entry.level, broadphase, timeoutMs, robust);
+        std::printf("%s: %s in %.0f ms, %zu ticks (%s)\n", info->name.c_str(), run.solved ? "solved" : "failed",
+            run.ms, run.ticks, run.report.c_str());
+        any |= run.solved;
+    }
+    const amm::CollisionMemo& memo = broadphase.memo();
+    std::printf("collision memo: %.1f%% hits over %llu lookups, %zu cells, %zu KB\n",
+        memo.lookups() ? 100.0 * (double)memo.hits() / (double)memo.lookups() : 0.0,
+        (unsigned long long)memo.lookups(), memo.cells(), memo.bytes() >> 10);
+    return any ? 0 : 1;
+}
+
+static int cmdBench(const fs::path& dir, int argc, char** argv) {
+    auto picked = pickStrategies(stringOption(argc, argv, 3, "--strategy", "all"));
+    if (picked.empty()) return 2;
+    int timeoutMs = intOption(argc, argv, 3, "--timeout-ms", DEFAULT_TIMEOUT_MS);
+    bool robust = flag(argc, argv, 3, "--robust");
+    int jobs = std::max(1, intOption(argc, argv, 3, "--jobs", 1));
+    size_t memoryBudget = (size_t)std::max(0, intOption(argc, argv, 3, "--memory-mb", 0)) << 20;
+    int metricsPort = intOption(argc, argv, 3, "--metrics-port", 0);
+
+    Corpus corpus;
+    if (!corpus.open(dir)) {
+        std::fprintf(stderr, "cannot open %s\n", dir.string().c_str());
+        return 1;
+    }
+    std::vector<std::string> names;
+    std::vector<amm::CorpusEntry> entries;
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        amm::CorpusEntry entry;
+        if (!corpus.load(i, entry)) {
+            std::fprintf(stderr, "skipping %s (unreadable)\n", corpus.name(i).c_str());
+            continue;
+        }
+        names.push_back(corpus.name(i));
+        entries.push_back(std::move(entry));
+    }
+    if (entries.empty()) {
+        std::fprintf(stderr, "no usable corpus entries in %s\n", dir.string().c_str());
+        return 1;
+    }
+
+    // One job per level and strategy, longest predicted first (BatchQueue.hpp).
+    std::vector<amm::CostEstimate> estimates(entries.size());
+    amm::BatchQueue queue(memoryBudget);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        estimates[i] = amm::estimateCost(entries[i].level);
+        for (size_t k = 0; k < picked.size(); ++k) queue.add(i * picked.size() + k, estimates[i]);
+    }
+    std::vector<StrategyRun> runs(entries.size() * picked.size());
+    BenchMetrics metrics(jobs);
+    metrics.queueDepth.set((double)queue.pending());
+    amm::MetricsServer server(metrics.registry);
+    if (metricsPort > 0) {
+        if (server.start(metricsPort))
+            std::printf("metrics on http://127.0.0.1:%d/metrics\n", metricsPort);
+        else
+            std::fprintf(stderr, "cannot listen on 127.0.0.1:%d, running without metrics\n", metricsPort);
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < jobs; ++w) {
+        workers.emplace_back([&, w]() {
+            BenchMetrics::Worker& wm = metrics.workers[(size_t)w];
+            size_t job;
+            while (queue.take(job)) {
+                metrics.queueDepth.set((double)queue.pending());
+                metrics.inFlight.add(1);
+                const amm::LevelSnapshot& level = entries[job / picked.size()].level;
+                amm::Broadphase broadphase;
+                broadphase.build(level);
+                double levelBytes = (double)snapshotBytes(level), bpBytes = (double)broadphaseBytes(broadphase);
+                metrics.snapshotBytes.add(levelBytes);
+                metrics.broadphaseBytes.add(bpBytes);
+
+                auto begin = std::chrono::steady_clock::now(), last = begin;
+                uint64_t lastWork = 0;
+                double searchBytes = 0.0;
+                runs[job] = runStrategy(*picked[job % picked.size()], level, broadphase, timeoutMs, robust,
+                    [&](const amm::SolveProgress& p, const amm::TreeEstimator& tree) {
+                        auto now = std::chrono::steady_clock::now();
+                        double dt = std::chrono::duration<double>(now - last).count();
+                        uint64_t work = std::max(lastWork, p.work + tree.searched());
+                        metrics.work.add(work - lastWork);
+                        if (dt > 0.0) wm.workPerSecond.set((double)(work - lastWork) / dt);
+                        wm.cacheEntries.set((double)p.cached);
+                        metrics.searchBytes.add((double)p.memory - searchBytes);
+                        searchBytes = (double)p.memory;
+                        last = now;
+                        lastWork = work;
+
+                        double total = amm::predictWork((double)work, p.fraction, tree.remaining());
+                        double elapsed = std::chrono::duration<double>(now - begin).count();
+                        wm.estimatedWork.set(total);
+                        wm.explored.set(total > 0.0 ? std::min(1.0, (double)work / total) : 0.0);
+                        wm.etaSeconds.set(total > 0.0 && work > 0 ? elapsed * (total - (double)work) / (double)work
+                                                                  : -1.0);
+                    });
+                metrics.searchBytes.add(-searchBytes);
+                metrics.snapshotBytes.add(-levelBytes);
+                metrics.broadphaseBytes.add(-bpBytes);
+                wm.workPerSecond.set(0.0);
+                wm.cacheEntries.set(0.0);
+                wm.estimatedWork.set(0.0);
+                wm.explored.set(0.0);
+                wm.etaSeconds.set(-1.0);
+                (runs[job].solved ? metrics.solved : metrics.failed).add();
+                metrics.latency.observe(runs[job].ms / 1000.0);
+                metrics.inFlight.add(-1);
+                queue.finish(job);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    server.stop();
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+    struct Totals {
+        size_t solved = 0;
+        double ms = 0.0;
+        uint64_t work = 0;
+    };
+    std::vector<Totals> totals(picked.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        std::printf("%s (predicted %.2gM work, %zu MB):", names[i].c_str(),
+            estimates[i].work / 1.0e6, estimates[i].memory >> 20);
+        for (size_t k = 0; k < picked.size(); ++k) {
+            const StrategyRun& run = runs[i * picked.size() + k];
+            totals[k].solved += run.solved;
+            totals[k].ms += run.ms;
+            totals[k].work += run.work;
+            std::printf("  %s %s %.0f ms", picked[k]->name.c_str(), run.solved ? "ok" : "FAIL", run.ms);
+        }
+        std::printf("\n");
+    }
+    for (size_t k = 0; k < picked.size(); ++k)
+        std::printf("%-10s %zu/%zu solved, %.0f ms total, %llu work units\n", picked[k]->name.c_str(),
+            totals[k].solved, entries.size(), totals[k].ms, (unsigned long long)totals[k].work);
+    std::printf("%d worker(s), %.0f ms wall\n", jobs, wallMs);
+    return 0;
+}
+
+// Golden corpus: stored timings and work counts per level, compared with a tolerance.
+// The file is text, one level per line after the header:
+//   <file> <solved 0|1> <ms> <work units> <memory bytes>
+static constexpr const char* BASELINE_HEADER = "amm-golden-baseline 1";
+static constexpr double TIME_NOISE_MS = 50.0; // slowdowns below this are never reported
+
+// The golden baseline is recorded from an optimized build; an unoptimized one is several
+// times slower, so its times say nothing against it.
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && defined(NDEBUG))
+static constexpr bool OPTIMIZED_BUILD = true;
+#else
+static constexpr bool OPTIMIZED_BUILD = false;
+#endif
+
+struct GoldenResult {
+    bool solved = false;
+    double ms = 0.0;
+    uint64_t work = 0;
+    size_t memory = 0;
+};
+
+static bool loadBaseline(const fs::path& path, std::map<std::string, GoldenResult>& out) {
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != BASELINE_HEADER) return false;
+    while (std::getline(in, line)) {
+        std::istringstream row(line);
+        std::string name;
+        GoldenResult r;
+        int solved = 0;
+        if (row >> name >> solved >> r.ms >> r.work >> r.memory) {
+            r.solved = solved != 0;
+            out[name] = r;
+        }
+    }
+    return true;
+}
+
+static bool saveBaseline(const fs::path& path, const std::map<std::string, GoldenResult>& results) {
+    std::ofstream out(path);
+    out << BASELINE_HEADER << "\n";
+    for (const auto& [name, r] : results)
+        out << name << " " << (r.solved ? 1 : 0) << " " << (uint64_t)r.ms << " " << r.work << " " << r.memory << "\n";
+    return (bool)out;
+}
+
+// Plays the stored solution through the physics clone; false if it no longer finishes.
+static bool replayFinishes(const amm::LevelSnapshot& level, const amm::Broadphase& broadphase,
+                           const amm::Timeline& inputs) {
+    amm::PlayerState s = amm::initialState(level);
+    for (uint8_t hold : inputs) {
+        amm::StepOutcome outcome = amm::stepPlayer(level, broadphase, s, hold != 0, SIM_DT);
+        if (outcome == amm::StepOutcome::Finished) return true;
+        if (outcome == amm::StepOutcome::Dead) return false;
+    }
+    return false;
+}
+
+static int cmdGolden(const fs::path& dir, const fs::path& baselinePath, int argc, char** argv) {
+    auto picked = pickStrategies(stringOption(argc, argv, 4, "--strategy", amm::strategies().front().name.c_str()));
+    if (picked.size() != 1) return 2;
+    int timeoutMs = intOption(argc, argv, 4, "--timeout-ms", DEFAULT_TIMEOUT_MS);
+    double tolerance = intOption(argc, argv, 4, "--tolerance", 25) / 100.0;
+    bool update = flag(argc, argv, 4, "--update");
+    if (update && !OPTIMIZED_BUILD) {
+        std::fprintf(stderr, "not recording a baseline from an unoptimized build (configure with "
+            "-DCMAKE_BUILD_TYPE=Release)\n");
+        return 2;
+    }
+    if (!OPTIMIZED_BUILD)
+        std::printf("unoptimized build: checking work and memory only, times are not compared\n");
+
+    std::map<std::string, GoldenResult> baseline;
+    if (!update && !loadBaseline(baselinePath, baseline)) {
+        std::fprintf(stderr, "no baseline at %s (run with --update to record one)\n", baselinePath.string().c_str());
+        return 2;
+    }
+
+    std::map<std::string, GoldenResult> results;
+    size_t failures = 0;
+    Corpus corpus;
+    if (!corpus.open(dir)) {
+        std::fprintf(stderr, "cannot open %s\n", dir.string().c_str());
+        return 2;
+    }
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        std::string name = corpus.name(i);
+        amm::CorpusEntry entry;
+        if (!corpus.load(i, entry)) {
+            std::printf("FAIL %s: unreadable\n", name.c_str());
+            failures++;
+            continue;
+        }
+        amm::Broadphase broadphase;
+        broadphase.build(entry.level);
+        std::vector<std::string> problems;
+        // The stored solution catches physics changes independently of the solver.
+        if (entry.solved && !replayFinishes(entry.level, broadphase, entry.solution))
+            problems.push_back("stored solution no longer finishes");
+
+        StrategyRun run = runStrategy(*picked[0], entry.level, broadphase, timeoutMs, false);
+        GoldenResult& r = results[name];
+        r.solved = run.solved;
+        r.ms = run.ms;
+        r.work = run.work;
+        r.memory = snapshotBytes(entry.level) + broadphaseBytes(broadphase) + run.peakMemory;
+
+        if (auto it = baseline.find(name); !update && it != baseline.end()) {
+            const GoldenResult& b = it->second;
+            if (b.solved && !r.solved) problems.push_back("no longer solved");
+            if (OPTIMIZED_BUILD && r.ms > b.ms * (1.0 + tolerance) && r.ms - b.ms > TIME_NOISE_MS)
+                problems.push_back("time " + std::to_string((int)b.ms) + " -> " + std::to_string((int)r.ms) + " ms");
+            if ((double)r.work > (double)b.work * (1.0 + tolerance))
+                problems.push_back("work " + std::to_string(b.work) + " -> " + std::to_string(r.work));
+            if ((double)r.memory > (double)b.memory * (1.0 + tolerance))
+                problems.push_back("memory " + std::to_string(b.memory) + " -> " + std::to_string(r.memory) + " bytes");
+        } else if (!update) {
+            problems.push_back("not in the baseline");
+        }
+
+        std::printf("%s %s: %s, %.0f ms, %llu work, %zu KB", problems.empty() ? "ok  " : "FAIL", name.c_str(),
+            r.solved ? "solved" : "unsolved", r.ms, (unsigned long long)r.work, r.memory >> 10);
+        for (const auto& p : problems) std::printf("; %s", p.c_str());
+        std::printf("\n");
+        failures += !problems.empty();
+    }
+    // A check over nothing would always pass.
+    if (corpus.size() == 0) {
+        std::fprintf(stderr, "no golden levels in %s\n", dir.string().c_str());
+        return 1;
+    }
+    size_t missing = 0;
+    for (const auto& [name, b] : baseline) {
+        if (results.count(name)) continue;
+        std::printf("FAIL %s: in the baseline but not in the corpus\n", name.c_str());
+        missing++;
+    }
+    failures += missing;
+
+    if (update) {
+        if (!saveBaseline(baselinePath, results)) {
+            std::fprintf(stderr, "cannot write %s\n", baselinePath.string().c_str());
+            return 1;
+        }
+        std::printf("baseline of %zu levels written to %s\n", results.size(), baselinePath.string().c_str());
+        return failures == 0 ? 0 : 1;
+    }
+    size_t levels = corpus.size() + missing;
+    std::printf("%zu/%zu levels within %.0f%% of the baseline\n", levels - failures, levels, tolerance * 100.0);
+    return failures == 0 ? 0 : 1;
+}
+
+static int cmdPack(const fs::path& dir, const fs::path& out) {
+    auto files = corpusFiles(dir);
+    amm::CorpusArchiveWriter writer;
+    if (!writer.open(out)) {
+        std::fprintf(stderr, "cannot write %s\n", out.string().c_str());
+        return 1;
+    }
+    size_t packed = 0;
+    for (const auto& file : files) {
+        amm::CorpusEntry entry;
+        if (!amm::loadCorpusEntry(file, entry)) {
+            std::fprintf(stderr, "skipping %s (unreadable)\n", file.string().c_str());
+            continue;
+        }
+        if (!writer.add(file.filename().string(), entry)) {
+            std::fprintf(stderr, "cannot write %s\n", out.string().c_str());
+            return 1;
+        }
+        packed++;
+    }
+    if (!writer.finish()) {
+        std::fprintf(stderr, "cannot write %s\n", out.string().c_str());
+        return 1;
+    }
+    std::printf("%zu entries, %zu KB -> %zu KB in %s\n", packed, writer.rawBytes() >> 10, writer.storedBytes() >> 10,
+        out.string().c_str());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    std::string cmd = argv[1];
+    if (cmd == "info" && argc >= 3) return cmdInfo(argv[2], argc, argv);
+    if (cmd == "train" && argc >= 4) return cmdTrain(argv[2], argv[3], argc, argv);
+    if (cmd == "solve" && argc >= 3) return cmdSolve(argv[2], argc, argv);
+    if (cmd == "bench" && argc >= 3) return cmdBench(argv[2], argc, argv);
+    if (cmd == "golden" && argc >= 4) return cmdGolden(argv[2], argv[3], argc, argv);
+    if (cmd == "pack" && argc >= 4) return cmdPack(argv[2], argv[3]);
+    if (cmd == "strategies") return cmdStrategies();
+    return usage();
+}
@@ -0,0 +1,59 @@
+// src/BatchQueue.cpp
+// AutomaticMacroMaker - cost-aware job queue for batch solving
+// Developer: entity12208
+
+#include "BatchQueue.hpp"
+
+#include <algorithm>
+
+namespace amm {
+
+void BatchQueue::add(size_t id, const CostEstimate& cost) {
+    m_pending.push_back({id, cost});
+    m_sorted = false;
+}
+
+bool BatchQueue::take(size_t& id) {
+    std::unique_lock lock(m_mutex);
+    if (!m_sorted) {
+        std::stable_sort(m_pending.begin(), m_pending.end(),
+            [](const Job& a, const Job& b) { return a.cost.work > b.cost.work; });
+        m_sorted = true;
+    }
+    for (;;) {
+        if (m_pending.empty()) return false;
+        auto it = m_pending.begin();
+        if (m_budget > 0) {
+            it = std::find_if(m_pending.begin(), m_pending.end(),
+                [&](const Job& j) { return m_inUse + j.cost.memory <= m_budget; });
+            // Nothing fits: run the longest job alone rather than never.
+            if (it == m_pending.end() && m_active.empty()) it = m_pending.begin();
+        }
+        if (it != m_pending.end()) {
+            id = it->id;
+            m_inUse += it->cost.memory;
+            m_active.push_back(*it);
+            m_pending.erase(it);
+            return true;
+        }
+        m_changed.wait(lock);
+    }
+}
+
+void BatchQueue::finish(size_t id) {
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = std::find_if(m_active.begin(), m_active.end(), [&](const Job& j) { return j.id == id; });
+        if (it == m_active.end()) return;
+        m_inUse -= it->cost.memory;
+        m_active.erase(it);
+    }
+    m_changed.notify_all();
+}
+
+size_t BatchQueue::pending() const {
+    std::lock_guard lock(m_mutex);
+    return m_pending.size();
+}
+
+} // namespace amm
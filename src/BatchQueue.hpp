@@ -0,0 +1,54 @@
+// src/BatchQueue.hpp
+// AutomaticMacroMaker - cost-aware job queue for batch solving
+// Developer: entity12208
+//
+// Batch runs (the CLI bench, corpus sweeps) solve many levels on a few worker threads.
+// Taken in file order, one huge level that happens to start last keeps a single worker
+// busy long after the rest are idle. The queue hands out the most expensive job first
+// (longest-processing-time scheduling, using SolveCost.hpp estimates) and keeps the
+// summed memory estimate of the running jobs under a budget: when the next-longest job
+// does not fit, the longest one that does is started instead, and a worker only waits
+// when nothing fits. A job larger than the whole budget still runs, alone.
+
+#pragma once
+
+#include "SolveCost.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace amm {
+
+class BatchQueue {
+public:
+    // `memoryBudget` in bytes; 0 = unlimited.
+    explicit BatchQueue(size_t memoryBudget = 0) : m_budget(memoryBudget) {}
+
+    // Not thread-safe: add every job before the workers start.
+    void add(size_t id, const CostEstimate& cost);
+
+    // Blocks until a job fits, then returns true with its id; false once the queue is
+    // drained. Every job taken must be handed back with finish().
+    bool take(size_t& id);
+    void finish(size_t id);
+
+    size_t pending() const;
+
+private:
+    struct Job {
+        size_t id;
+        CostEstimate cost;
+    };
+
+    size_t m_budget;
+    size_t m_inUse = 0;
+    bool m_sorted = false;
+    std::vector<Job> m_pending;  // most expensive first once sorted
+    std::vector<Job> m_active;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+};
+
+} // namespace amm
@@ -0,0 +1,63 @@
+// src/BitStateSet.cpp
+// AutomaticMacroMaker - lossy visited set using a few bits per state
+// Developer: entity12208
+
+#include "BitStateSet.hpp"
+
+#include <algorithm>
+
+namespace amm {
+
+static inline uint64_t mixBits(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+BitStateSet::BitStateSet(size_t bits, int hashes) : m_hashes(std::clamp(hashes, 1, 16)) {
+    uint64_t size = 64;
+    while (size < bits) size <<= 1;
+    m_mask = size - 1;
+    m_words.assign(size / 64, 0);
+}
+
+void BitStateSet::clear() {
+    std::fill(m_words.begin(), m_words.end(), 0);
+    m_setBits = 0;
+    m_inserted = 0;
+    m_omissions = 0.0;
+}
+
+bool BitStateSet::insert(uint64_t key) {
+    // Double hashing: bit i is h1 + i * h2, which behaves like k independent hashes.
+    uint64_t h1 = mixBits(key);
+    uint64_t h2 = mixBits(key ^ 0x9e3779b97f4a7c15ull) | 1;
+    double p = falsePositiveRate();
+
+    bool fresh = false;
+    for (int i = 0; i < m_hashes; ++i) {
+        uint64_t bit = (h1 + (uint64_t)i * h2) & m_mask;
+        uint64_t& word = m_words[bit >> 6];
+        uint64_t m = 1ull << (bit & 63);
+        if (!(word & m)) {
+            word |= m;
+            m_setBits++;
+            fresh = true;
+        }
+    }
+    // Every distinct state the search reaches has chance p of colliding with the bits
+    // already set; summing it over the states that did get in estimates the ones lost.
+    if (fresh) {
+        m_inserted++;
+        m_omissions += p;
+    }
+    return fresh;
+}
+
+double BitStateSet::falsePositiveRate() const {
+    double f = fill(), p = 1.0;
+    for (int i = 0; i < m_hashes; ++i) p *= f;
+    return p;
+}
+
+} // namespace amm
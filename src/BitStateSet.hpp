@@ -0,0 +1,52 @@
+// src/BitStateSet.hpp
+// AutomaticMacroMaker - lossy visited set using a few bits per state
+// Developer: entity12208
+//
+// The exact visited set of the tick search costs 16 to 32 bytes per state, which caps
+// how long an exhaustive search can run before memory does. The bit-state set (a
+// Bloom filter, "supertrace" in model-checking terms) stores each state as k bits in
+// one large bitmap. It never forgets a state, but it can claim a new state was already
+// visited once the bitmap fills up, and the search then prunes it. Those false
+// positives are what makes it lossy, so it keeps an estimate of how many states were
+// wrongly pruned, and the solver reports that estimate with its stats.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+class BitStateSet {
+public:
+    static constexpr int DEFAULT_HASHES = 3;
+
+    // `bits` is rounded up to a power of two (at least 64).
+    explicit BitStateSet(size_t bits, int hashes = DEFAULT_HASHES);
+
+    // Forgets every state; the bitmap keeps its size.
+    void clear();
+
+    // Marks the state, returning true if it was not (seemingly) seen before.
+    bool insert(uint64_t key);
+
+    size_t bytes() const { return m_words.size() * sizeof(uint64_t); }
+    uint64_t inserted() const { return m_inserted; }
+    // Share of bits set; the chance a new state is wrongly pruned is fill()^hashes.
+    double fill() const { return (double)m_setBits / (double)(m_mask + 1); }
+    double falsePositiveRate() const;
+    // Expected number of distinct states pruned without ever being expanded since
+    // clear(): the false-positive chance summed over the states that were inserted.
+    double expectedOmissions() const { return m_omissions; }
+
+private:
+    std::vector<uint64_t> m_words;
+    uint64_t m_mask = 0;
+    int m_hashes;
+    uint64_t m_setBits = 0;
+    uint64_t m_inserted = 0;
+    double m_omissions = 0.0;
+};
+
+} // namespace amm
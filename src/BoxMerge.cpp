@@ -0,0 +1,108 @@
+// src/BoxMerge.cpp
+// AutomaticMacroMaker - adjacent blocks merged into large rectangles at compile time
+// Developer: entity12208
+
+#include "BoxMerge.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+namespace amm {
+
+namespace {
+
+struct Rect {
+    float minX, minY, maxX, maxY;
+    HitKind kind;
+    uint32_t first;   // lowest box index in the rectangle
+    uint32_t parent;  // itself, or the rectangle it was merged into
+};
+
+uint32_t root(std::vector<Rect>& rects, uint32_t r) {
+    while (rects[r].parent != r) r = rects[r].parent = rects[rects[r].parent].parent;
+    return r;
+}
+
+// Merges, in place, rectangles that share the coordinates `same` picks and touch or
+// overlap along the axis `span` picks.
+template <class Same, class Span>
+void mergeRuns(std::vector<Rect>& rects, std::vector<uint32_t> ids, Same same, Span span) {
+    std::sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) {
+        auto ka = same(rects[a]), kb = same(rects[b]);
+        if (ka != kb) return ka < kb;
+        return span(rects[a]).first < span(rects[b]).first;
+    });
+    uint32_t cur = UINT32_MAX;
+    for (uint32_t id : ids) {
+        Rect& r = rects[id];
+        if (cur != UINT32_MAX && same(rects[cur]) == same(r) && span(r).first <= span(rects[cur]).second) {
+            Rect& c = rects[cur];
+            c.minX = std::min(c.minX, r.minX);
+            c.minY = std::min(c.minY, r.minY);
+            c.maxX = std::max(c.maxX, r.maxX);
+            c.maxY = std::max(c.maxY, r.maxY);
+            c.first = std::min(c.first, r.first);
+            r.parent = cur;
+            continue;
+        }
+        cur = id;
+    }
+}
+
+} // namespace
+
+std::vector<uint32_t> mergeBoxes(BoxSet& boxes, const std::vector<uint8_t>& pinned, BoxMergeStats* stats) {
+    size_t n = boxes.size();
+    std::vector<Rect> rects(n);
+    std::vector<uint32_t> solids, hazards;
+    for (uint32_t i = 0; i < n; ++i) {
+        rects[i] = {boxes.minX[i], boxes.minY[i], boxes.maxX[i], boxes.maxY[i], boxes.kind[i], i, i};
+        if (i < pinned.size() && pinned[i]) continue;
+        if (boxes.kind[i] == HitKind::Hazard) hazards.push_back(i);
+        else if (boxes.kind[i] == HitKind::Solid) solids.push_back(i);
+    }
+
+    auto rows = [](const Rect& r) { return std::make_tuple(r.minY, r.maxY); };
+    auto alongX = [](const Rect& r) { return std::make_pair(r.minX, r.maxX); };
+    mergeRuns(rects, solids, rows, alongX);
+    mergeRuns(rects, hazards, rows, alongX);
+
+    // Then stack the hazard runs that share their left and right edges.
+    std::vector<uint32_t> runs;
+    for (uint32_t i : hazards)
+        if (rects[i].parent == i) runs.push_back(i);
+    mergeRuns(rects, runs, [](const Rect& r) { return std::make_tuple(r.minX, r.maxX); },
+        [](const Rect& r) { return std::make_pair(r.minY, r.maxY); });
+
+    // Rebuild: each rectangle is written where its first box was.
+    BoxSet merged;
+    std::vector<uint32_t> remap(n), slot(n, UINT32_MAX);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t r = root(rects, i);
+        if (rects[r].first == i) {
+            slot[r] = (uint32_t)merged.size();
+            merged.add(rects[r].minX, rects[r].minY, rects[r].maxX, rects[r].maxY, rects[r].kind);
+        }
+    }
+    for (uint32_t i = 0; i < n; ++i) remap[i] = slot[root(rects, i)];
+
+    if (stats) {
+        stats->before += n;
+        stats->after += merged.size();
+    }
+    boxes = std::move(merged);
+    return remap;
+}
+
+BoxMergeStats mergeStaticBoxes(CompiledLevel& compiled) {
+    std::vector<uint8_t> pinned(compiled.level.boxes.size(), 0);
+    for (const DynamicShape& d : compiled.dynamic)
+        if (d.family == ShapeFamily::Box) pinned[d.index] = 1;
+    BoxMergeStats stats;
+    std::vector<uint32_t> remap = mergeBoxes(compiled.level.boxes, pinned, &stats);
+    for (DynamicShape& d : compiled.dynamic)
+        if (d.family == ShapeFamily::Box) d.index = remap[d.index];
+    return stats;
+}
+
+} // namespace amm
@@ -0,0 +1,43 @@
+// src/BoxMerge.hpp
+// AutomaticMacroMaker - adjacent blocks merged into large rectangles at compile time
+// Developer: entity12208
+//
+// Levels are built from thousands of 30x30 blocks, and a floor of them costs one
+// broadphase entry and one contact test per block although it collides like a single
+// rectangle. This pass merges adjacent or overlapping boxes of the same kind into
+// maximal rectangles where doing so cannot change what the physics sees:
+//  - hazards only kill on overlap, so any set of hazard boxes that exactly tiles a
+//    rectangle becomes that rectangle: runs along X with the same bottom and top, then
+//    stacks of those with the same left and right;
+//  - solids resolve against their bottom and top faces, once per distinct surface
+//    (stepPlayer, Physics.cpp), so they are only merged along X, between boxes with the
+//    same bottom and top. The player touches the merged box exactly when it touched one
+//    of the originals, and resolves against the same set of surfaces as before.
+// Pads and orbs fire once per object and are never merged; neither are pinned boxes
+// (the ones triggers move). Coordinates must match exactly, so nothing is snapped.
+
+#pragma once
+
+#include "CompiledLevel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+struct BoxMergeStats {
+    size_t before = 0; // boxes
+    size_t after = 0;
+};
+
+// Merges the boxes not flagged in `pinned` (empty = none pinned). Merged rectangles take
+// the place of their first box, and the other boxes keep their order. Returns the new
+// index of every old box.
+std::vector<uint32_t> mergeBoxes(BoxSet& boxes, const std::vector<uint8_t>& pinned,
+                                 BoxMergeStats* stats = nullptr);
+
+// The same for a compiled level: its dynamic boxes are pinned and renumbered.
+BoxMergeStats mergeStaticBoxes(CompiledLevel& compiled);
+
+} // namespace amm
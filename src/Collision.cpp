@@ -0,0 +1,307 @@
+// src/Collision.cpp
+// AutomaticMacroMaker - broadphase and batched narrow-phase collision tests
+// Developer: entity12208
+
+#include "Collision.hpp"
+#include "CollisionMemo.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+// ---------- Broadphase ----------
+
+static constexpr uint32_t FAMILY_BOX = 0;
+static constexpr uint32_t FAMILY_ORIENTED = 1;
+static constexpr uint32_t FAMILY_TRIANGLE = 2;
+static constexpr uint32_t FAMILY_CIRCLE = 3;
+static constexpr uint32_t ENTRY_FIRST_COLUMN = 1u << 29;
+static constexpr uint32_t ENTRY_INDEX_MASK = ENTRY_FIRST_COLUMN - 1;
+
+static inline uint32_t packEntry(uint32_t family, uint32_t index) { return (family << 30) | index; }
+
+Broadphase::Broadphase() : m_memo(std::make_unique<CollisionMemo>()) {}
+Broadphase::~Broadphase() = default;
+Broadphase::Broadphase(Broadphase&&) noexcept = default;
+Broadphase& Broadphase::operator=(Broadphase&&) noexcept = default;
+
+int Broadphase::columnOf(float x) const {
+    return (int)std::floor((x - m_originX) / COLUMN_WIDTH);
+}
+
+void Broadphase::build(const LevelSnapshot& level) {
+    struct Span { float x0, x1; uint32_t entry; };
+    std::vector<Span> spans;
+    spans.reserve(level.shapeCount());
+
+    const auto& b = level.boxes;
+    for (uint32_t i = 0; i < b.size(); ++i)
+        spans.push_back({b.minX[i], b.maxX[i], packEntry(FAMILY_BOX, i)});
+
+    const auto& o = level.orientedBoxes;
+    for (uint32_t i = 0; i < o.size(); ++i) {
+        float ext = std::fabs(o.cosA[i]) * o.hx[i] + std::fabs(o.sinA[i]) * o.hy[i];
+        spans.push_back({o.cx[i] - ext, o.cx[i] + ext, packEntry(FAMILY_ORIENTED, i)});
+    }
+
+    const auto& t = level.triangles;
+    for (uint32_t i = 0; i < t.size(); ++i) {
+        float x0 = std::min({t.ax[i], t.bx[i], t.cx[i]});
+        float x1 = std::max({t.ax[i], t.bx[i], t.cx[i]});
+        spans.push_back({x0, x1, packEntry(FAMILY_TRIANGLE, i)});
+    }
+
+    const auto& c = level.circles;
+    for (uint32_t i = 0; i < c.size(); ++i)
+        spans.push_back({c.cx[i] - c.r[i], c.cx[i] + c.r[i], packEntry(FAMILY_CIRCLE, i)});
+
+    m_offsets.clear();
+    m_entries.clear();
+    m_memo = std::make_unique<CollisionMemo>();
+    if (spans.empty()) return;
+
+    m_originX = spans[0].x0;
+    float maxX = spans[0].x1;
+    for (const auto& s : spans) {
+        m_originX = std::min(m_originX, s.x0);
+        maxX = std::max(maxX, s.x1);
+    }
+
+    size_t columns = (size_t)columnOf(maxX) + 1;
+    m_offsets.assign(columns + 1, 0);
+    for (const auto& s : spans)
+        for (int col = columnOf(s.x0); col <= columnOf(s.x1); ++col) m_offsets[col + 1]++;
+    for (size_t i = 0; i < columns; ++i) m_offsets[i + 1] += m_offsets[i];
+
+    m_entries.resize(m_offsets.back());
+    std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    for (const auto& s : spans) {
+        int first = columnOf(s.x0);
+        for (int col = first; col <= columnOf(s.x1); ++col)
+            m_entries[cursor[col]++] = s.entry | (col == first ? ENTRY_FIRST_COLUMN : 0u);
+    }
+}
+
+void Broadphase::query(const Aabb& box, ShapeList& out) const {
+    if (m_offsets.empty()) return;
+    queryColumns(columnOf(box.minX), columnOf(box.maxX), out);
+}
+
+void Broadphase::queryColumns(int c0, int c1, ShapeList& out) const {
+    if (m_offsets.empty()) return;
+    c0 = std::max(c0, 0);
+    c1 = std::min(c1, (int)columnCount() - 1);
+
+    for (int col = c0; col <= c1; ++col) {
+        for (uint32_t e = m_offsets[col]; e < m_offsets[col + 1]; ++e) {
+            uint32_t entry = m_entries[e];
+            // A shape spanning several queried columns is only reported from the first one.
+            if (col != c0 && !(entry & ENTRY_FIRST_COLUMN)) continue;
+            uint32_t index = entry & ENTRY_INDEX_MASK;
+            switch (entry >> 30) {
+                case FAMILY_BOX: out.boxes.push_back(index); break;
+                case FAMILY_ORIENTED: out.orientedBoxes.push_back(index); break;
+                case FAMILY_TRIANGLE: out.triangles.push_back(index); break;
+                default: out.circles.push_back(index); break;
+            }
+        }
+    }
+}
+
+Aabb shapeBounds(const LevelSnapshot& level, ShapeFamily family, uint32_t i) {
+    switch (family) {
+        case ShapeFamily::Box:
+            return {level.boxes.minX[i], level.boxes.minY[i], level.boxes.maxX[i], level.boxes.maxY[i]};
+        case ShapeFamily::OrientedBox: {
+            const auto& o = level.orientedBoxes;
+            float ex = std::fabs(o.cosA[i]) * o.hx[i] + std::fabs(o.sinA[i]) * o.hy[i];
+            float ey = std::fabs(o.sinA[i]) * o.hx[i] + std::fabs(o.cosA[i]) * o.hy[i];
+            return {o.cx[i] - ex, o.cy[i] - ey, o.cx[i] + ex, o.cy[i] + ey};
+        }
+        case ShapeFamily::Triangle: {
+            const auto& t = level.triangles;
+            return {std::min({t.ax[i], t.bx[i], t.cx[i]}), std::min({t.ay[i], t.by[i], t.cy[i]}),
+                    std::max({t.ax[i], t.bx[i], t.cx[i]}), std::max({t.ay[i], t.by[i], t.cy[i]})};
+        }
+        default: {
+            const auto& c = level.circles;
+            return {c.cx[i] - c.r[i], c.cy[i] - c.r[i], c.cx[i] + c.r[i], c.cy[i] + c.r[i]};
+        }
+    }
+}
+
+// ---------- Narrow-phase kernels ----------
+//
+// All kernels gather four candidates into stack arrays, run the test on the lanes type
+// and compact the overlapping lanes into `hits`. Lanes past n are masked off.
+
+static inline size_t emitHits(int mask, size_t lanes, const uint32_t* idx, uint32_t* hits, size_t count) {
+    mask &= (1 << lanes) - 1;
+    for (size_t l = 0; l < lanes; ++l)
+        if (mask & (1 << l)) hits[count++] = idx[l];
+    return count;
+}
+
+template <class L>
+static size_t boxKernel(const BoxSet& s, const uint32_t* idx, size_t n, const Aabb& p, uint32_t* hits) {
+    const auto pMinX = L::splat(p.minX), pMinY = L::splat(p.minY);
+    const auto pMaxX = L::splat(p.maxX), pMaxY = L::splat(p.maxY);
+    float x0[4] = {}, y0[4] = {}, x1[4] = {}, y1[4] = {};
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 4) {
+        size_t lanes = std::min<size_t>(4, n - i);
+        for (size_t l = 0; l < lanes; ++l) {
+            uint32_t k = idx[i + l];
+            x0[l] = s.minX[k]; y0[l] = s.minY[k]; x1[l] = s.maxX[k]; y1[l] = s.maxY[k];
+        }
+        auto overlapX = L::band(L::lt(L::load(x0), pMaxX), L::lt(pMinX, L::load(x1)));
+        auto overlapY = L::band(L::lt(L::load(y0), pMaxY), L::lt(pMinY, L::load(y1)));
+        count = emitHits(L::bits(L::band(overlapX, overlapY)), lanes, idx + i, hits, count);
+    }
+    return count;
+}
+
+template <class L>
+static size_t orientedBoxKernel(const OrientedBoxSet& s, const uint32_t* idx, size_t n, const Aabb& p, uint32_t* hits) {
+    const auto pcx = L::splat((p.minX + p.maxX) * 0.5f), pcy = L::splat((p.minY + p.maxY) * 0.5f);
+    const auto phx = L::splat((p.maxX - p.minX) * 0.5f), phy = L::splat((p.maxY - p.minY) * 0.5f);
+    float cx[4] = {}, cy[4] = {}, hx[4] = {}, hy[4] = {}, ca[4] = {}, sa[4] = {};
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 4) {
+        size_t lanes = std::min<size_t>(4, n - i);
+        for (size_t l = 0; l < lanes; ++l) {
+            uint32_t k = idx[i + l];
+            cx[l] = s.cx[k]; cy[l] = s.cy[k]; hx[l] = s.hx[k]; hy[l] = s.hy[k];
+            ca[l] = s.cosA[k]; sa[l] = s.sinA[k];
+        }
+        auto c = L::load(ca), sn = L::load(sa);
+        auto ac = L::abs(c), as = L::abs(sn);
+        auto bhx = L::load(hx), bhy = L::load(hy);
+        auto dx = L::sub(L::load(cx), pcx), dy = L::sub(L::load(cy), pcy);
+
+        // Player axes: project the oriented box onto world X / Y.
+        auto extX = L::add(L::add(L::mul(ac, bhx), L::mul(as, bhy)), phx);
+        auto extY = L::add(L::add(L::mul(as, bhx), L::mul(ac, bhy)), phy);
+        auto m = L::band(L::lt(L::abs(dx), extX), L::lt(L::abs(dy), extY));
+
+        // Box axes: project the player box onto u = (c, s) and v = (-s, c).
+        auto du = L::abs(L::add(L::mul(dx, c), L::mul(dy, sn)));
+        auto dv = L::abs(L::sub(L::mul(dy, c), L::mul(dx, sn)));
+        auto extU = L::add(bhx, L::add(L::mul(phx, ac), L::mul(phy, as)));
+        auto extV = L::add(bhy, L::add(L::mul(phx, as), L::mul(phy, ac)));
+        m = L::band(m, L::band(L::lt(du, extU), L::lt(dv, extV)));
+
+        count = emitHits(L::bits(m), lanes, idx + i, hits, count);
+    }
+    return count;
+}
+
+// Separating-axis test of the player box against the triangle edge (a, b) whose
+// opposite vertex is o.
+template <class L>
+static typename L::M triangleEdgeAxis(typename L::F ax, typename L::F ay, typename L::F bx, typename L::F by,
+                                      typename L::F ox, typename L::F oy,
+                                      typename L::F pcx, typename L::F pcy, typename L::F phx, typename L::F phy) {
+    auto nx = L::sub(ay, by);
+    auto ny = L::sub(bx, ax);
+    auto pa = L::add(L::mul(nx, ax), L::mul(ny, ay));
+    auto po = L::add(L::mul(nx, ox), L::mul(ny, oy));
+    auto triMin = L::min(pa, po), triMax = L::max(pa, po);
+    auto center = L::add(L::mul(nx, pcx), L::mul(ny, pcy));
+    auto radius = L::add(L::mul(phx, L::abs(nx)), L::mul(phy, L::abs(ny)));
+    return L::band(L::lt(triMin, L::add(center, radius)), L::lt(L::sub(center, radius), triMax));
+}
+
+template <class L>
+static size_t triangleKernel(const TriangleSet& s, const uint32_t* idx, size_t n, const Aabb& p, uint32_t* hits) {
+    const auto pMinX = L::splat(p.minX), pMinY = L::splat(p.minY);
+    const auto pMaxX = L::splat(p.maxX), pMaxY = L::splat(p.maxY);
+    const auto pcx = L::splat((p.minX + p.maxX) * 0.5f), pcy = L::splat((p.minY + p.maxY) * 0.5f);
+    const auto phx = L::splat((p.maxX - p.minX) * 0.5f), phy = L::splat((p.maxY - p.minY) * 0.5f);
+    float axs[4] = {}, ays[4] = {}, bxs[4] = {}, bys[4] = {}, cxs[4] = {}, cys[4] = {};
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 4) {
+        size_t lanes = std::min<size_t>(4, n - i);
+        for (size_t l = 0; l < lanes; ++l) {
+            uint32_t k = idx[i + l];
+            axs[l] = s.ax[k]; ays[l] = s.ay[k]; bxs[l] = s.bx[k];
+            bys[l] = s.by[k]; cxs[l] = s.cx[k]; cys[l] = s.cy[k];
+        }
+        auto ax = L::load(axs), ay = L::load(ays), bx = L::load(bxs);
+        auto by = L::load(bys), cx = L::load(cxs), cy = L::load(cys);
+
+        auto m = L::band(L::lt(L::min(ax, L::min(bx, cx)), pMaxX), L::lt(pMinX, L::max(ax, L::max(bx, cx))));
+        m = L::band(m, L::band(L::lt(L::min(ay, L::min(by, cy)), pMaxY), L::lt(pMinY, L::max(ay, L::max(by, cy)))));
+        m = L::band(m, triangleEdgeAxis<L>(ax, ay, bx, by, cx, cy, pcx, pcy, phx, phy));
+        m = L::band(m, triangleEdgeAxis<L>(bx, by, cx, cy, ax, ay, pcx, pcy, phx, phy));
+        m = L::band(m, triangleEdgeAxis<L>(cx, cy, ax, ay, bx, by, pcx, pcy, phx, phy));
+
+        count = emitHits(L::bits(m), lanes, idx + i, hits, count);
+    }
+    return count;
+}
+
+template <class L>
+static size_t circleKernel(const CircleSet& s, const uint32_t* idx, size_t n, const Aabb& p, uint32_t* hits) {
+    const auto pMinX = L::splat(p.minX), pMinY = L::splat(p.minY);
+    const auto pMaxX = L::splat(p.maxX), pMaxY = L::splat(p.maxY);
+    float cxs[4] = {}, cys[4] = {}, rs[4] = {};
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i += 4) {
+        size_t lanes = std::min<size_t>(4, n - i);
+        for (size_t l = 0; l < lanes; ++l) {
+            uint32_t k = idx[i + l];
+            cxs[l] = s.cx[k]; cys[l] = s.cy[k]; rs[l] = s.r[k];
+        }
+        auto cx = L::load(cxs), cy = L::load(cys), r = L::load(rs);
+        // Closest point of the player box to the circle center.
+        auto dx = L::sub(cx, L::max(pMinX, L::min(cx, pMaxX)));
+        auto dy = L::sub(cy, L::max(pMinY, L::min(cy, pMaxY)));
+        auto d2 = L::add(L::mul(dx, dx), L::mul(dy, dy));
+        count = emitHits(L::bits(L::lt(d2, L::mul(r, r))), lanes, idx + i, hits, count);
+    }
+    return count;
+}
+
+template <class L>
+static CollisionKernels makeKernels(const char* name) {
+    return {name, &boxKernel<L>, &orientedBoxKernel<L>, &triangleKernel<L>, &circleKernel<L>};
+}
+
+const CollisionKernels& collisionKernels() {
+    static const CollisionKernels scalar = makeKernels<simd::ScalarLanes>("scalar");
+    static const CollisionKernels native = makeKernels<simd::NativeLanes>(simd::backendName(simd::nativeBackend()));
+    return simd::activeBackend() == simd::Backend::Scalar ? scalar : native;
+}
+
+void findContacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player,
+                  ShapeList& candidates, ShapeList& contacts) {
+    candidates.clear();
+    contacts.clear();
+    broadphase.query(player, candidates);
+    if (candidates.empty()) return;
+
+    const CollisionKernels& k = collisionKernels();
+    auto run = [&](auto fn, const auto& set, const std::vector<uint32_t>& in, std::vector<uint32_t>& out) {
+        if (in.empty()) return;
+        out.resize(in.size());
+        out.resize(fn(set, in.data(), in.size(), player, out.data()));
+    };
+    run(k.boxes, level.boxes, candidates.boxes, contacts.boxes);
+    run(k.orientedBoxes, level.orientedBoxes, candidates.orientedBoxes, contacts.orientedBoxes);
+    run(k.triangles, level.triangles, candidates.triangles, contacts.triangles);
+    run(k.circles, level.circles, candidates.circles, contacts.circles);
+}
+
+void findPlayerContacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player, float half,
+                        ShapeList& candidates, ShapeList& contacts) {
+    broadphase.memo().contacts(level, broadphase, player, half, candidates, contacts);
+}
+
+} // namespace amm
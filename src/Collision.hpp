@@ -0,0 +1,101 @@
+// src/Collision.hpp
+// AutomaticMacroMaker - broadphase and batched narrow-phase collision tests
+// Developer: entity12208
+//
+// The player hitbox is always axis-aligned. Level shapes come in four families:
+//  - boxes:          plain AABB overlap
+//  - oriented boxes: separating-axis test on the 2 box axes + 2 player axes
+//  - triangles:      separating-axis test on X, Y and the 3 edge normals (2.2 slopes)
+//  - circles:        closest-point test (saws)
+// Each family has a kernel that tests four candidates per iteration; the kernels are
+// picked at runtime (see Simd.hpp) and always fed from Broadphase::query.
+
+#pragma once
+
+#include "LevelSnapshot.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace amm {
+
+class CollisionMemo;
+
+struct Aabb {
+    float minX, minY, maxX, maxY;
+};
+
+// Indices into the snapshot's shape sets, one list per family.
+struct ShapeList {
+    std::vector<uint32_t> boxes, orientedBoxes, triangles, circles;
+
+    void clear() { boxes.clear(); orientedBoxes.clear(); triangles.clear(); circles.clear(); }
+    bool empty() const { return boxes.empty() && orientedBoxes.empty() && triangles.empty() && circles.empty(); }
+};
+
+// Uniform grid of X columns. Every shape is registered in each column its X extent
+// touches; queries visit only the columns the player box covers.
+class Broadphase {
+public:
+    static constexpr float COLUMN_WIDTH = 60.0f;
+
+    Broadphase();
+    ~Broadphase();
+    Broadphase(Broadphase&&) noexcept;
+    Broadphase& operator=(Broadphase&&) noexcept;
+
+    // Also empties the collision memo.
+    void build(const LevelSnapshot& level);
+
+    // Appends each shape whose columns overlap the box's X range exactly once.
+    void query(const Aabb& box, ShapeList& out) const;
+    // The same for the columns c0..c1, in the order query() gives for a box starting in c0.
+    void queryColumns(int c0, int c1, ShapeList& out) const;
+
+    int columnOf(float x) const;
+    float originX() const { return m_originX; }
+    size_t columnCount() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    size_t entryCount() const { return m_entries.size(); }
+
+    // Player collisions answered so far for the level it was built from (CollisionMemo.hpp).
+    // Shared by every thread that steps the player against this broadphase.
+    CollisionMemo& memo() const { return *m_memo; }
+
+private:
+    float m_originX = 0.0f;
+    std::vector<uint32_t> m_offsets; // CSR offsets, columnCount() + 1
+    std::vector<uint32_t> m_entries; // family (2 bits) | starts-here (1 bit) | index (29 bits)
+    std::unique_ptr<CollisionMemo> m_memo;
+};
+
+// Axis-aligned bounds of shape `index` in the given family (see ShapeList).
+enum class ShapeFamily : uint8_t { Box, OrientedBox, Triangle, Circle };
+Aabb shapeBounds(const LevelSnapshot& level, ShapeFamily family, uint32_t index);
+
+// Narrow-phase kernel table. Each function tests the candidates idx[0..n) against the
+// player box and writes the indices that overlap to hits (capacity >= n), returning
+// how many were written. Touching edges do not count as overlap.
+struct CollisionKernels {
+    const char* name;
+    size_t (*boxes)(const BoxSet&, const uint32_t* idx, size_t n, const Aabb& player, uint32_t* hits);
+    size_t (*orientedBoxes)(const OrientedBoxSet&, const uint32_t* idx, size_t n, const Aabb& player, uint32_t* hits);
+    size_t (*triangles)(const TriangleSet&, const uint32_t* idx, size_t n, const Aabb& player, uint32_t* hits);
+    size_t (*circles)(const CircleSet&, const uint32_t* idx, size_t n, const Aabb& player, uint32_t* hits);
+};
+
+// Kernels for simd::activeBackend().
+const CollisionKernels& collisionKernels();
+
+// Broadphase query followed by the narrow phase. `candidates` is scratch space the
+// caller keeps around between calls to avoid reallocating; `contacts` receives the
+// overlapping shapes.
+void findContacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player,
+                  ShapeList& candidates, ShapeList& contacts);
+
+// findContacts for the player's hitbox (playerBox, half size `half`), with the same
+// contacts in the same order, answered through the broadphase's memo.
+void findPlayerContacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player, float half,
+                        ShapeList& candidates, ShapeList& contacts);
+
+} // namespace amm
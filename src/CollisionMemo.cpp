@@ -0,0 +1,170 @@
+// src/CollisionMemo.cpp
+// AutomaticMacroMaker - exact player collisions memoized per grid cell, shared by all workers
+// Developer: entity12208
+
+#include "CollisionMemo.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace amm {
+
+static constexpr uint32_t SURE = 1u << 31; // every hitbox in the cell overlaps the box
+
+struct CollisionMemo::Cell {
+    Key key;
+    std::vector<uint32_t> items; // boxes, oriented boxes, triangles, circles, each in query order
+    uint32_t end[4] = {};        // family f is items[f ? end[f - 1] : 0, end[f])
+    uint32_t live[4] = {};       // items of family f that need the narrow phase
+    Aabb swept;                  // covers every hitbox of the cell
+    Aabb spanned;                // every hitbox of the cell reaches from below minX / minY to past maxX / maxY
+
+    // The player box is one of the cell's hitboxes as far as the items are concerned:
+    // inside the swept box, so no candidate is missing, and spanning the region that
+    // makes the marked boxes sure.
+    bool covers(const Aabb& p) const {
+        return p.minX >= swept.minX && p.minY >= swept.minY && p.maxX <= swept.maxX && p.maxY <= swept.maxY &&
+            p.minX <= spanned.maxX && p.minY <= spanned.maxY && p.maxX >= spanned.minX && p.maxY >= spanned.minY;
+    }
+};
+
+// How far float rounding may move a hitbox edge near `v`, with room to spare.
+static float slack(float v) { return 0.05f + std::fabs(v) * 1.0e-6f; }
+
+static std::vector<uint32_t>& family(ShapeList& list, int f) {
+    switch (f) {
+        case 0: return list.boxes;
+        case 1: return list.orientedBoxes;
+        case 2: return list.triangles;
+        default: return list.circles;
+    }
+}
+
+// Runs the narrow-phase kernel of family f on idx[0..n).
+static size_t narrow(const LevelSnapshot& level, int f, const uint32_t* idx, size_t n, const Aabb& box,
+                     uint32_t* hits) {
+    const CollisionKernels& k = collisionKernels();
+    switch (f) {
+        case 0: return k.boxes(level.boxes, idx, n, box, hits);
+        case 1: return k.orientedBoxes(level.orientedBoxes, idx, n, box, hits);
+        case 2: return k.triangles(level.triangles, idx, n, box, hits);
+        default: return k.circles(level.circles, idx, n, box, hits);
+    }
+}
+
+CollisionMemo::CollisionMemo() : m_slots(new std::atomic<Cell*>[SLOTS]) {}
+
+CollisionMemo::~CollisionMemo() {
+    for (size_t i = 0; i < SLOTS; ++i) delete m_slots[i].load(std::memory_order_relaxed);
+}
+
+uint64_t CollisionMemo::hits() const {
+    uint64_t lookups = m_lookups.value(), misses = m_misses.value();
+    return lookups > misses ? lookups - misses : 0;
+}
+
+size_t CollisionMemo::bytes() const {
+    return SLOTS * sizeof(std::atomic<Cell*>) + cells() * sizeof(Cell) +
+        m_items.load(std::memory_order_relaxed) * sizeof(uint32_t);
+}
+
+const CollisionMemo::Cell* CollisionMemo::find(const LevelSnapshot& level, const Broadphase& broadphase,
+                                               const Key& key) {
+    uint32_t halfBits;
+    std::memcpy(&halfBits, &key.half, sizeof(halfBits));
+    uint64_t h = ((uint64_t)(uint32_t)key.x << 32 | (uint32_t)key.y) * 0x9e3779b97f4a7c15ull;
+    h ^= ((uint64_t)(uint32_t)key.column << 32 | halfBits) * 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 29;
+
+    std::unique_ptr<Cell> built;
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        std::atomic<Cell*>& slot = m_slots[(h + probe) & (SLOTS - 1)];
+        Cell* cell = slot.load(std::memory_order_acquire);
+        if (!cell) {
+            if (!built) {
+                m_misses.add();
+                built = std::make_unique<Cell>();
+                built->key = key;
+
+                // Hitboxes of the cell start in [a, a + CELL) x [b, b + CELL). The edge is
+                // found from the origin in double, so it holds wherever the origin is.
+                float size = 2.0f * key.half;
+                float a = (float)((double)broadphase.originX() + (double)key.x * CELL), b = (float)key.y * CELL;
+                float sx = slack(a), sy = slack(b);
+                Aabb swept{a - sx, b - sy, a + CELL + size + sx, b + CELL + size + sy};
+                built->swept = swept;
+                built->spanned = {a + size - sx, b + size - sy, a + CELL + sx, b + CELL + sy};
+
+                ShapeList candidates;
+                broadphase.queryColumns(key.column, broadphase.columnOf(swept.maxX), candidates);
+                std::vector<uint32_t> reach;
+                for (int f = 0; f < 4; ++f) {
+                    const std::vector<uint32_t>& in = family(candidates, f);
+                    reach.resize(in.size());
+                    reach.resize(narrow(level, f, in.data(), in.size(), swept, reach.data()));
+                    for (uint32_t i : reach) {
+                        bool sure = f == 0 && level.boxes.minX[i] < a + size - sx && level.boxes.maxX[i] > a + CELL + sx &&
+                            level.boxes.minY[i] < b + size - sy && level.boxes.maxY[i] > b + CELL + sy;
+                        built->items.push_back(sure ? i | SURE : i);
+                        built->live[f] += !sure;
+                    }
+                    built->end[f] = (uint32_t)built->items.size();
+                }
+            }
+            if (slot.compare_exchange_strong(cell, built.get(), std::memory_order_acq_rel)) {
+                m_cells.fetch_add(1, std::memory_order_relaxed);
+                m_items.fetch_add(built->items.size(), std::memory_order_relaxed);
+                return built.release();
+            }
+            // Another thread took the slot first; `cell` is its entry.
+        }
+        if (cell->key == key) return cell;
+    }
+    return nullptr;
+}
+
+void CollisionMemo::contacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player,
+                             float half, ShapeList& candidates, ShapeList& contacts) {
+    if (broadphase.columnCount() == 0) {
+        candidates.clear();
+        contacts.clear();
+        return;
+    }
+    m_lookups.add();
+    Key key{broadphase.columnOf(player.minX),
+            (int32_t)std::floor(((double)player.minX - (double)broadphase.originX()) / CELL),
+            (int32_t)std::floor(player.minY / CELL), half};
+    const Cell* cell = find(level, broadphase, key);
+    // A box that rounding puts outside its cell is answered directly rather than wrongly.
+    if (!cell || !cell->covers(player)) {
+        if (cell) m_misses.add();
+        findContacts(level, broadphase, player, candidates, contacts);
+        return;
+    }
+
+    thread_local std::vector<uint32_t> hits;
+    candidates.clear();
+    contacts.clear();
+    for (int f = 0; f < 4; ++f) {
+        const uint32_t* items = cell->items.data() + (f ? cell->end[f - 1] : 0);
+        size_t count = cell->end[f] - (f ? cell->end[f - 1] : 0);
+        std::vector<uint32_t>& out = family(contacts, f);
+        if (cell->live[f] == 0) {
+            for (size_t i = 0; i < count; ++i) out.push_back(items[i] & ~SURE);
+            continue;
+        }
+        std::vector<uint32_t>& maybe = family(candidates, f);
+        for (size_t i = 0; i < count; ++i)
+            if (!(items[i] & SURE)) maybe.push_back(items[i]);
+        hits.resize(maybe.size());
+        size_t found = narrow(level, f, maybe.data(), maybe.size(), player, hits.data());
+        for (size_t i = 0, h = 0; i < count; ++i) {
+            if (items[i] & SURE) out.push_back(items[i] & ~SURE);
+            else if (h < found && hits[h] == items[i]) out.push_back(hits[h++]);
+        }
+    }
+}
+
+} // namespace amm
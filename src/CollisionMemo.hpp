@@ -0,0 +1,70 @@
+// src/CollisionMemo.hpp
+// AutomaticMacroMaker - exact player collisions memoized per grid cell, shared by all workers
+// Developer: entity12208
+//
+// Sibling branches of a search keep stepping the player through the same few places,
+// and every step repeats the broadphase walk and the narrow phase for them. The memo
+// splits player positions into cells: the column the hitbox starts in, its bottom-left
+// corner on a CELL grid, and the hitbox size (one per gamemode). For each cell it keeps,
+// in the order findContacts reports them, the shapes some hitbox in the cell could
+// touch, and marks the boxes that every hitbox in the cell overlaps. A lookup copies the
+// marked boxes and runs the narrow phase only on the unmarked shapes, so contacts come
+// out exactly as without the memo; in open air and inside large blocks a cell has no
+// unmarked shapes and the lookup is nearly free. The bounds of a cell are computed from
+// the broadphase origin in double and widened by a few float ulps; a hitbox that still
+// falls outside the cell it was looked up in goes to findContacts instead.
+//
+// The level is fixed for the lifetime of the broadphase that owns the memo (triggers
+// are applied by rebase() before it is built), so cells never go stale. The table is
+// lock-free: a cell is built outside it and published with one compare-and-swap, the
+// loser of a race drops its copy. Once full, lookups that miss fall back to
+// findContacts.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "Metrics.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace amm {
+
+class CollisionMemo {
+public:
+    static constexpr float CELL = 15.0f;         // divides Broadphase::COLUMN_WIDTH
+    static constexpr size_t SLOTS = 1 << 17;     // cells, power of two
+    static constexpr size_t MAX_PROBES = 16;     // open addressing, then give up
+
+    CollisionMemo();
+    ~CollisionMemo();
+    CollisionMemo(const CollisionMemo&) = delete;
+    CollisionMemo& operator=(const CollisionMemo&) = delete;
+
+    // See findPlayerContacts (Collision.hpp).
+    void contacts(const LevelSnapshot& level, const Broadphase& broadphase, const Aabb& player, float half,
+                  ShapeList& candidates, ShapeList& contacts);
+
+    uint64_t lookups() const { return m_lookups.value(); }
+    uint64_t hits() const;
+    size_t cells() const { return m_cells.load(std::memory_order_relaxed); }
+    size_t bytes() const;
+
+private:
+    struct Key {
+        int32_t column, x, y;
+        float half;
+        bool operator==(const Key&) const = default;
+    };
+    struct Cell;
+
+    const Cell* find(const LevelSnapshot& level, const Broadphase& broadphase, const Key& key);
+
+    std::unique_ptr<std::atomic<Cell*>[]> m_slots;
+    std::atomic<size_t> m_cells{0}, m_items{0};
+    Counter m_lookups, m_misses;
+};
+
+} // namespace amm
@@ -0,0 +1,157 @@
+// src/CompiledLevel.cpp
+// AutomaticMacroMaker - level extracted once, rebased onto the live state per request
+// Developer: entity12208
+
+#include "CompiledLevel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+static constexpr float DEG_TO_RAD = 3.14159265f / 180.0f;
+static constexpr float POSE_EPSILON = 0.01f;
+
+namespace {
+
+// Shapes rebase() removes, per family (ShapeFamily order), flagged by index.
+using DropMask = std::vector<uint8_t>;
+
+// Maps a point from the compiled pose of its object to the live one.
+struct PoseDelta {
+    float fromX, fromY, toX, toY, c, s;
+
+    void apply(float& x, float& y) const {
+        float dx = x - fromX, dy = y - fromY;
+        x = toX + dx * c - dy * s;
+        y = toY + dx * s + dy * c;
+    }
+};
+
+void moveShape(LevelSnapshot& level, const DynamicShape& d, const PoseDelta& p, bool turned, DropMask* drop) {
+    uint32_t i = d.index;
+    switch (d.family) {
+        case ShapeFamily::Box: {
+            auto& b = level.boxes;
+            if (!turned) {
+                float dx = p.toX - p.fromX, dy = p.toY - p.fromY;
+                b.minX[i] += dx; b.maxX[i] += dx; b.minY[i] += dy; b.maxY[i] += dy;
+                return;
+            }
+            // A turned box is no longer axis-aligned: re-add it as an oriented box and
+            // drop the original once every dynamic shape has been moved.
+            float cx = (b.minX[i] + b.maxX[i]) * 0.5f, cy = (b.minY[i] + b.maxY[i]) * 0.5f;
+            float hx = (b.maxX[i] - b.minX[i]) * 0.5f, hy = (b.maxY[i] - b.minY[i]) * 0.5f;
+            p.apply(cx, cy);
+            level.orientedBoxes.add(cx, cy, hx, hy, p.c, p.s, b.kind[i]);
+            drop[(size_t)ShapeFamily::Box][i] = 1;
+            return;
+        }
+        case ShapeFamily::OrientedBox: {
+            auto& o = level.orientedBoxes;
+            p.apply(o.cx[i], o.cy[i]);
+            float c = o.cosA[i] * p.c - o.sinA[i] * p.s;
+            float s = o.sinA[i] * p.c + o.cosA[i] * p.s;
+            o.cosA[i] = c;
+            o.sinA[i] = s;
+            return;
+        }
+        case ShapeFamily::Triangle: {
+            auto& t = level.triangles;
+            p.apply(t.ax[i], t.ay[i]);
+            p.apply(t.bx[i], t.by[i]);
+            p.apply(t.cx[i], t.cy[i]);
+            return;
+        }
+        default:
+            p.apply(level.circles.cx[i], level.circles.cy[i]);
+            return;
+    }
+}
+
+// Keeps the entries of `v` not flagged in `drop`, in order. Entries past the mask were
+// added by this rebase and stay.
+template <class T> void compact(std::vector<T>& v, const DropMask& drop) {
+    size_t n = 0;
+    for (size_t i = 0; i < v.size(); ++i)
+        if (i >= drop.size() || !drop[i]) v[n++] = v[i];
+    v.resize(n);
+}
+
+// Removes the flagged shapes. Shape indices change, so this runs after every move.
+void dropShapes(LevelSnapshot& level, const DropMask* drop) {
+    auto any = [](const DropMask& m) { return std::find(m.begin(), m.end(), 1) != m.end(); };
+    if (any(drop[(size_t)ShapeFamily::Box])) {
+        const DropMask& m = drop[(size_t)ShapeFamily::Box];
+        auto& b = level.boxes;
+        compact(b.minX, m); compact(b.minY, m); compact(b.maxX, m); compact(b.maxY, m); compact(b.kind, m);
+    }
+    if (any(drop[(size_t)ShapeFamily::OrientedBox])) {
+        const DropMask& m = drop[(size_t)ShapeFamily::OrientedBox];
+        auto& o = level.orientedBoxes;
+        compact(o.cx, m); compact(o.cy, m); compact(o.hx, m); compact(o.hy, m);
+        compact(o.cosA, m); compact(o.sinA, m); compact(o.kind, m);
+    }
+    if (any(drop[(size_t)ShapeFamily::Triangle])) {
+        const DropMask& m = drop[(size_t)ShapeFamily::Triangle];
+        auto& t = level.triangles;
+        compact(t.ax, m); compact(t.ay, m); compact(t.bx, m); compact(t.by, m);
+        compact(t.cx, m); compact(t.cy, m); compact(t.kind, m);
+    }
+    if (any(drop[(size_t)ShapeFamily::Circle])) {
+        const DropMask& m = drop[(size_t)ShapeFamily::Circle];
+        auto& c = level.circles;
+        compact(c.cx, m); compact(c.cy, m); compact(c.r, m); compact(c.kind, m);
+    }
+}
+
+} // namespace
+
+LevelSnapshot rebase(const CompiledLevel& compiled, const std::vector<ObjectPose>& livePose,
+                     const LiveStart& live, RebaseStats* stats) {
+    LevelSnapshot level = compiled.level;
+    RebaseStats local;
+    DropMask drop[4] = {DropMask(level.boxes.size()), DropMask(level.orientedBoxes.size()),
+                        DropMask(level.triangles.size()), DropMask(level.circles.size())};
+
+    for (const DynamicShape& d : compiled.dynamic) {
+        if (d.object >= livePose.size() || d.object >= compiled.compiledPose.size()) continue;
+        const ObjectPose& from = compiled.compiledPose[d.object];
+        const ObjectPose& to = livePose[d.object];
+        if (!to.enabled) {
+            drop[(size_t)d.family][d.index] = 1;
+            local.disabled++;
+            continue;
+        }
+        float turn = to.rotation - from.rotation;
+        bool turned = std::fabs(turn) > POSE_EPSILON;
+        if (!turned && std::fabs(to.x - from.x) <= POSE_EPSILON && std::fabs(to.y - from.y) <= POSE_EPSILON) continue;
+
+        // cocos rotation is clockwise in degrees
+        PoseDelta delta{from.x, from.y, to.x, to.y, std::cos(-turn * DEG_TO_RAD), std::sin(-turn * DEG_TO_RAD)};
+        moveShape(level, d, delta, turned, drop);
+        local.moved++;
+        if (turned) local.rotated++;
+    }
+    if (local.disabled > 0 || local.rotated > 0) dropShapes(level, drop);
+
+    level.startX = live.x;
+    level.startY = live.y;
+    level.startVy = live.vy;
+    level.startFlipped = live.flipped;
+
+    // The section the player is in takes the live gamemode and speed. Passed sections
+    // stay, so section indices, and with them the entry states of a SectionCache kept
+    // across solves (Strategy.hpp), mean the same in every rebase.
+    Section& here = level.sections[level.sectionAt(live.x)];
+    here.setGravity = -1;
+    if (live.known) {
+        here.mode = live.mode;
+        here.speed = live.speed;
+    }
+
+    if (stats) *stats = local;
+    return level;
+}
+
+} // namespace amm
@@ -0,0 +1,86 @@
+// src/CompiledLevel.hpp
+// AutomaticMacroMaker - level extracted once, rebased onto the live state per request
+// Developer: entity12208
+//
+// Walking every GameObject of a big level on each "M" press is the slowest part of a
+// request, yet almost none of it changes between presses. The glue therefore compiles
+// the whole level once (all shapes, one section per portal from the very start) and
+// caches it. What can differ at pause time is small:
+//  - the player: position, velocity, gravity, gamemode and speed;
+//  - objects in groups that gameplay-relevant triggers act on (TriggerSlice.hpp), which
+//    the compiled level lists as dynamic shapes together with the pose they had when
+//    compiled.
+// rebase() copies the compiled arrays, moves just the dynamic shapes by the difference
+// between their live and compiled pose, drops the ones a toggle trigger has switched
+// off, and puts the live gamemode and speed into the section at the live X. It keeps
+// the sections already passed, so indices into them stay valid from one rebase to the
+// next.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "LevelSnapshot.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace amm {
+
+struct ObjectPose {
+    float x = 0.0f, y = 0.0f;
+    float rotation = 0.0f; // degrees
+    bool enabled = true;   // false once a toggle trigger has switched the object off
+};
+
+// A shape whose object may be moved by triggers. `object` indexes the dynamic objects
+// (CompiledLevel::compiledPose); the glue keeps the matching engine objects, and finds
+// them again through objectIndex when the same level is loaded into a new PlayLayer.
+struct DynamicShape {
+    ShapeFamily family;
+    uint32_t index;
+    uint32_t object;
+};
+
+// An object that changes the player in a way the physics clone does not model (a mini
+// portal, a dash orb, ...); see scanFeasibility (Feasibility.hpp). It matters once the
+// player's hitbox overlaps its box; a trigger that fires as the player passes its X has
+// an unbounded height.
+struct UnsupportedObject {
+    float x = 0.0f, y = 0.0f;
+    float halfWidth = 0.0f, halfHeight = std::numeric_limits<float>::infinity();
+    const char* what = ""; // "mini portal"
+};
+
+struct CompiledLevel {
+    LevelSnapshot level;                  // sections start at -inf, no live player state
+    std::vector<DynamicShape> dynamic;
+    std::vector<ObjectPose> compiledPose; // per dynamic object, as extracted
+    std::vector<uint32_t> objectIndex;    // per dynamic object, its place in the engine's object list
+    size_t objectCount = 0;               // engine objects seen, to detect edits
+    size_t triggersKept = 0, triggersDropped = 0; // TriggerSlice.hpp, for the log
+    size_t boxesMerged = 0;               // boxes saved by mergeStaticBoxes (BoxMerge.hpp), for the log
+    std::vector<UnsupportedObject> unsupported; // by X
+};
+
+// What the live player looks like at pause time.
+struct LiveStart {
+    float x = 0.0f, y = 105.0f, vy = 0.0f;
+    bool flipped = false;
+    bool known = false; // mode / speed below are valid (there is a player)
+    Gamemode mode = Gamemode::Cube;
+    float speed = 311.58f;
+};
+
+struct RebaseStats {
+    size_t moved = 0;       // dynamic shapes whose pose changed
+    size_t rotated = 0;     // of those, shapes that also turned about their object
+    size_t disabled = 0;    // dynamic shapes dropped because their object is off
+};
+
+// Snapshot of the compiled level at the live state. `livePose` holds the current pose
+// of every dynamic object, in compiledPose order.
+LevelSnapshot rebase(const CompiledLevel& compiled, const std::vector<ObjectPose>& livePose,
+                     const LiveStart& live, RebaseStats* stats = nullptr);
+
+} // namespace amm
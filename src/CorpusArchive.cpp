@@ -0,0 +1,222 @@
+// src/CorpusArchive.cpp
+// AutomaticMacroMaker - many corpus entries packed into one memory-mapped file
+// Developer: entity12208
+
+#include "CorpusArchive.hpp"
+#include "Lz.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace amm {
+
+static constexpr uint32_t ARCHIVE_MAGIC = 0x504d4d41; // "AMMP"
+static constexpr uint32_t ARCHIVE_VERSION = 1;
+
+namespace {
+
+struct Header {
+    uint32_t magic = ARCHIVE_MAGIC;
+    uint32_t version = ARCHIVE_VERSION;
+    uint32_t count = 0;
+    uint32_t reserved = 0;
+    uint64_t indexOffset = 0;
+    uint64_t namesOffset = 0;
+};
+static_assert(sizeof(Header) == 32 && sizeof(ArchiveEntry) == 40, "archive layout changed");
+
+uint64_t fnv1a(const uint8_t* p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+bool before(const ArchiveEntry& a, uint64_t id, uint64_t hash) {
+    return a.id != id ? a.id < id : a.hash < hash;
+}
+
+} // namespace
+
+uint64_t levelId(std::string_view name) {
+    return fnv1a(reinterpret_cast<const uint8_t*>(name.data()), name.size());
+}
+
+CorpusArchiveWriter::~CorpusArchiveWriter() {
+    if (m_file) std::fclose(m_file);
+    std::error_code ec;
+    if (!m_path.empty() && !m_finished) std::filesystem::remove(m_path, ec);
+}
+
+bool CorpusArchiveWriter::open(const std::filesystem::path& path) {
+    m_path = path;
+#ifdef _WIN32
+    m_file = _wfopen(path.c_str(), L"wb");
+#else
+    m_file = std::fopen(path.c_str(), "wb");
+#endif
+    Header header;
+    m_offset = sizeof(header);
+    return m_file && std::fwrite(&header, sizeof(header), 1, m_file) == 1;
+}
+
+bool CorpusArchiveWriter::add(const std::string& name, const CorpusEntry& entry) {
+    if (!m_file) return false;
+    encodeCorpusEntry(entry, m_raw);
+    m_packed.clear();
+    lzCompress(m_raw.data(), m_raw.size(), m_packed);
+    const std::vector<uint8_t>& stored = m_packed.size() < m_raw.size() ? m_packed : m_raw;
+
+    ArchiveEntry e;
+    e.id = levelId(name);
+    e.hash = fnv1a(m_raw.data(), m_raw.size());
+    e.offset = m_offset;
+    e.storedSize = (uint32_t)stored.size();
+    e.rawSize = (uint32_t)m_raw.size();
+    e.nameOffset = (uint32_t)m_names.size();
+    e.nameLength = (uint32_t)name.size();
+    if (std::fwrite(stored.data(), 1, stored.size(), m_file) != stored.size()) return false;
+    m_offset += stored.size();
+    m_names += name;
+    m_index.push_back(e);
+    m_rawBytes += m_raw.size();
+    m_storedBytes += stored.size();
+    return true;
+}
+
+bool CorpusArchiveWriter::finish() {
+    if (!m_file) return false;
+    std::sort(m_index.begin(), m_index.end(),
+        [](const ArchiveEntry& a, const ArchiveEntry& b) { return before(a, b.id, b.hash); });
+    static const uint8_t zeros[8] = {};
+    size_t pad = (8 - m_offset % 8) % 8;
+    Header header;
+    header.count = (uint32_t)m_index.size();
+    header.indexOffset = m_offset + pad;
+    header.namesOffset = header.indexOffset + m_index.size() * sizeof(ArchiveEntry);
+    bool ok = std::fwrite(zeros, 1, pad, m_file) == pad &&
+        std::fwrite(m_index.data(), sizeof(ArchiveEntry), m_index.size(), m_file) == m_index.size() &&
+        std::fwrite(m_names.data(), 1, m_names.size(), m_file) == m_names.size() &&
+        std::fseek(m_file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, m_file) == 1;
+    ok = std::fclose(m_file) == 0 && ok;
+    m_file = nullptr;
+    m_finished = ok;
+    return ok;
+}
+
+bool CorpusArchive::open(const std::filesystem::path& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+        ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+        : nullptr;
+    CloseHandle(file);
+    if (!mapping) return false;
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    m_mapping = mapping;
+    m_size = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* p = fstat(fd, &st) == 0 && st.st_size > 0
+        ? mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED;
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    m_data = static_cast<const uint8_t*>(p);
+    m_size = (size_t)st.st_size;
+#endif
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    Header header;
+    if (m_size < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, m_data, sizeof(header));
+    uint64_t indexEnd = header.indexOffset + (uint64_t)header.count * sizeof(ArchiveEntry);
+    if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION || header.indexOffset % 8 != 0 ||
+        header.indexOffset < sizeof(header) || indexEnd > header.namesOffset || header.namesOffset > m_size) {
+        close();
+        return false;
+    }
+    m_index = reinterpret_cast<const ArchiveEntry*>(m_data + header.indexOffset);
+    m_count = header.count;
+    m_names = reinterpret_cast<const char*>(m_data + header.namesOffset);
+    m_namesSize = m_size - header.namesOffset;
+    for (size_t i = 0; i < m_count; ++i) {
+        const ArchiveEntry& e = m_index[i];
+        if (e.offset < sizeof(header) || e.offset + e.storedSize > header.indexOffset || e.storedSize > e.rawSize ||
+            (uint64_t)e.nameOffset + e.nameLength > m_namesSize) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void CorpusArchive::close() {
+    if (m_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    }
+#ifdef _WIN32
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+#endif
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_size = m_count = m_namesSize = 0;
+    m_index = nullptr;
+    m_names = nullptr;
+}
+
+std::string_view CorpusArchive::name(size_t i) const {
+    return {m_names + m_index[i].nameOffset, m_index[i].nameLength};
+}
+
+size_t CorpusArchive::find(std::string_view name) const {
+    uint64_t id = levelId(name);
+    const ArchiveEntry* end = m_index + m_count;
+    const ArchiveEntry* it = std::lower_bound(m_index, end, id,
+        [](const ArchiveEntry& e, uint64_t v) { return e.id < v; });
+    for (; it != end && it->id == id; ++it)
+        if (this->name((size_t)(it - m_index)) == name) return (size_t)(it - m_index);
+    return m_count;
+}
+
+bool CorpusArchive::load(size_t i, CorpusEntry& out) const {
+    const ArchiveEntry& e = m_index[i];
+    const uint8_t* raw = packed(i);
+    std::vector<uint8_t> buffer;
+    if (e.storedSize < e.rawSize) {
+        buffer.resize(e.rawSize);
+        if (!lzDecompress(raw, e.storedSize, buffer.data(), buffer.size())) return false;
+        raw = buffer.data();
+    }
+    return fnv1a(raw, e.rawSize) == e.hash && decodeCorpusEntry(raw, e.rawSize, out);
+}
+
+} // namespace amm
@@ -0,0 +1,114 @@
+// src/CorpusArchive.hpp
+// AutomaticMacroMaker - many corpus entries packed into one memory-mapped file
+// Developer: entity12208
+//
+// A corpus of thousands of .amms files costs a directory walk, an open and a read per
+// level before any solving starts. A packed archive holds the same entries in one
+// file: each entry's bytes (the .amms encoding, SnapshotIO.hpp) compressed on their
+// own (Lz.hpp, or stored as is when that does not pay), followed by an index sorted by
+// level ID and content hash, and the entry names.
+//
+// Layout, all little-endian:
+//   header   magic "AMMP", version, entry count, 0, index offset (u64), names offset (u64)
+//   blobs    one per entry, back to back
+//   index    `count` IndexEntry records, sorted by (id, hash), 8-byte aligned
+//   names    the entry names, back to back
+// The level ID is a 64-bit hash of the entry name (the .amms file name) and the content
+// hash one of the uncompressed bytes, checked again on load.
+//
+// The reader maps the file and reads the index in place: find() is a binary search
+// and packed() hands out the stored bytes without copying them. Only decoding an entry
+// into a CorpusEntry copies.
+
+#pragma once
+
+#include "SnapshotIO.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace amm {
+
+static constexpr const char* CORPUS_ARCHIVE_EXTENSION = ".ammp";
+
+uint64_t levelId(std::string_view name);
+
+struct ArchiveEntry {
+    uint64_t id = 0;
+    uint64_t hash = 0;        // of the uncompressed bytes
+    uint64_t offset = 0;      // of the stored bytes, from the file start
+    uint32_t storedSize = 0;  // equal to rawSize when stored uncompressed
+    uint32_t rawSize = 0;
+    uint32_t nameOffset = 0;  // into the names block
+    uint32_t nameLength = 0;
+};
+
+class CorpusArchiveWriter {
+public:
+    CorpusArchiveWriter() = default;
+    // Closes the file and removes it unless finish() succeeded: a half-written archive
+    // has a zeroed header and must not be left behind.
+    ~CorpusArchiveWriter();
+    CorpusArchiveWriter(const CorpusArchiveWriter&) = delete;
+    CorpusArchiveWriter& operator=(const CorpusArchiveWriter&) = delete;
+
+    // Entries are appended to `path` as they are added; finish() writes the index.
+    bool open(const std::filesystem::path& path);
+    bool add(const std::string& name, const CorpusEntry& entry);
+    bool finish();
+
+    size_t rawBytes() const { return m_rawBytes; }
+    size_t storedBytes() const { return m_storedBytes; }
+
+private:
+    std::FILE* m_file = nullptr;
+    std::filesystem::path m_path;
+    bool m_finished = false;
+    uint64_t m_offset = 0;
+    std::vector<ArchiveEntry> m_index;
+    std::string m_names;
+    std::vector<uint8_t> m_raw, m_packed;
+    size_t m_rawBytes = 0, m_storedBytes = 0;
+};
+
+class CorpusArchive {
+public:
+    CorpusArchive() = default;
+    ~CorpusArchive() { close(); }
+    CorpusArchive(const CorpusArchive&) = delete;
+    CorpusArchive& operator=(const CorpusArchive&) = delete;
+
+    // False if the file cannot be mapped or its header or index is malformed.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    // Entries in index order.
+    size_t size() const { return m_count; }
+    const ArchiveEntry& entry(size_t i) const { return m_index[i]; }
+    std::string_view name(size_t i) const;
+
+    // Index of the entry named `name`, or size() if there is none. O(log n).
+    size_t find(std::string_view name) const;
+
+    // Stored (possibly compressed) bytes of entry i, inside the mapping.
+    const uint8_t* packed(size_t i) const { return m_data + m_index[i].offset; }
+
+    // Decompresses and decodes entry i; false if it is corrupt.
+    bool load(size_t i, CorpusEntry& out) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    const ArchiveEntry* m_index = nullptr;
+    size_t m_count = 0;
+    const char* m_names = nullptr;
+    size_t m_namesSize = 0;
+    void* m_mapping = nullptr; // platform handle (Windows only)
+};
+
+} // namespace amm
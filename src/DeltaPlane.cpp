@@ -0,0 +1,72 @@
+// src/DeltaPlane.cpp
+// AutomaticMacroMaker - bit-packed delta encoding for per-tick frontier columns
+// Developer: entity12208
+
+#include "DeltaPlane.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace amm {
+
+void DeltaPlane::encode(const uint16_t* values, size_t n) {
+    m_size = n;
+    m_blocks.clear();
+    m_bits.clear();
+    size_t blocks = (n + BLOCK - 1) / BLOCK;
+    m_blocks.reserve(blocks);
+
+    uint64_t bitPos = 0;
+    int32_t deltas[BLOCK];
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t begin = b * BLOCK, count = std::min(BLOCK, n - begin);
+        int32_t lo = 0, hi = 0;
+        for (size_t k = 1; k < count; ++k) {
+            deltas[k] = (int32_t)values[begin + k] - (int32_t)values[begin + k - 1];
+            lo = k == 1 ? deltas[k] : std::min(lo, deltas[k]);
+            hi = k == 1 ? deltas[k] : std::max(hi, deltas[k]);
+        }
+        uint8_t width = (uint8_t)std::bit_width((uint32_t)(hi - lo));
+        m_blocks.push_back({(uint32_t)bitPos, lo, values[begin], width});
+        if (width == 0) continue;
+
+        m_bits.resize((bitPos + (count - 1) * width + 63) / 64 + 1, 0);
+        for (size_t k = 1; k < count; ++k, bitPos += width) {
+            uint64_t v = (uint32_t)(deltas[k] - lo);
+            size_t word = bitPos >> 6, shift = bitPos & 63;
+            m_bits[word] |= v << shift;
+            if (shift + width > 64) m_bits[word + 1] |= v >> (64 - shift);
+        }
+    }
+    m_blocks.shrink_to_fit();
+    m_bits.shrink_to_fit();
+}
+
+size_t DeltaPlane::decodeBlock(size_t b, uint16_t* out) const {
+    const Block& blk = m_blocks[b];
+    size_t count = std::min(BLOCK, m_size - b * BLOCK);
+    out[0] = blk.base;
+    if (blk.width == 0) {
+        for (size_t k = 1; k < count; ++k) out[k] = (uint16_t)(out[k - 1] + blk.minDelta);
+        return count;
+    }
+    const uint64_t mask = (1ull << blk.width) - 1;
+    uint64_t bitPos = blk.bitOffset;
+    int32_t v = blk.base;
+    for (size_t k = 1; k < count; ++k, bitPos += blk.width) {
+        size_t word = bitPos >> 6, shift = bitPos & 63;
+        uint64_t raw = m_bits[word] >> shift;
+        if (shift + blk.width > 64) raw |= m_bits[word + 1] << (64 - shift);
+        v += blk.minDelta + (int32_t)(raw & mask);
+        out[k] = (uint16_t)v;
+    }
+    return count;
+}
+
+uint16_t DeltaPlane::at(size_t i) const {
+    uint16_t block[BLOCK];
+    decodeBlock(i / BLOCK, block);
+    return block[i % BLOCK];
+}
+
+} // namespace amm
@@ -0,0 +1,54 @@
+// src/DeltaPlane.hpp
+// AutomaticMacroMaker - bit-packed delta encoding for per-tick frontier columns
+// Developer: entity12208
+//
+// The flight grid keeps one back-pointer per occupied cell for every tick of a
+// section, which is most of its memory on long flying parts. Consecutive cells of a
+// tick were inserted while walking the previous tick in order, so their parents are
+// nearly sorted: neighbouring entries differ by a few units. A DeltaPlane stores each
+// entry as its difference to the entry before it, less the smallest difference in its
+// block of BLOCK entries, bit-packed at the narrowest width that fits the block. The
+// block's first value is kept absolute as the column-local base.
+//
+// Entries are decoded a block at a time: at() decodes at most one block, and
+// decodeBlock() hands a whole block to callers that walk the plane in order.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+class DeltaPlane {
+public:
+    static constexpr size_t BLOCK = 64;
+
+    DeltaPlane() = default;
+    explicit DeltaPlane(const std::vector<uint16_t>& values) { encode(values.data(), values.size()); }
+
+    void encode(const uint16_t* values, size_t n);
+
+    size_t size() const { return m_size; }
+    uint16_t at(size_t i) const;
+    // Writes the entries of block `b` (BLOCK of them, fewer for the last block) to out.
+    size_t decodeBlock(size_t b, uint16_t* out) const;
+
+    // Heap bytes held, for stats; compare with size() * sizeof(uint16_t).
+    size_t bytes() const { return m_blocks.capacity() * sizeof(Block) + m_bits.capacity() * sizeof(uint64_t); }
+
+private:
+    struct Block {
+        uint32_t bitOffset; // into m_bits
+        int32_t minDelta;   // added back to every packed delta
+        uint16_t base;      // first entry of the block, stored as is
+        uint8_t width;      // bits per packed delta (0 when all deltas equal minDelta)
+    };
+
+    size_t m_size = 0;
+    std::vector<Block> m_blocks;
+    std::vector<uint64_t> m_bits;
+};
+
+} // namespace amm
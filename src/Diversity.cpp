@@ -0,0 +1,59 @@
+// src/Diversity.cpp
+// AutomaticMacroMaker - keeping several substantially different solutions
+// Developer: entity12208
+
+#include "Diversity.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+std::vector<uint32_t> pressTicks(const Timeline& inputs) {
+    std::vector<uint32_t> out;
+    uint8_t prev = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i] && !prev) out.push_back((uint32_t)i);
+        prev = inputs[i];
+    }
+    return out;
+}
+
+namespace {
+
+// Presses of `a` with no press of `b` within slack ticks. Both lists are sorted.
+size_t unmatched(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, uint32_t slack) {
+    size_t count = 0, j = 0;
+    for (uint32_t t : a) {
+        while (j < b.size() && b[j] + slack < t) ++j;
+        if (j == b.size() || b[j] > t + slack) ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+size_t pressDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, uint32_t slack) {
+    return unmatched(a, b, slack) + unmatched(b, a, slack);
+}
+
+SolutionSet::SolutionSet(size_t capacity, float minFraction)
+    : m_capacity(std::max<size_t>(capacity, 1)), m_minFraction(minFraction) {}
+
+bool SolutionSet::offer(const Timeline& inputs) {
+    if (full()) return false;
+    auto presses = pressTicks(inputs);
+    for (const auto& kept : m_presses) {
+        size_t larger = std::max(presses.size(), kept.size());
+        size_t needed = std::max<size_t>(1, (size_t)std::ceil(m_minFraction * (float)larger));
+        if (pressDistance(presses, kept, PRESS_SLACK) < needed) {
+            m_rejected++;
+            return false;
+        }
+    }
+    m_solutions.push_back(inputs);
+    m_presses.push_back(std::move(presses));
+    return true;
+}
+
+} // namespace amm
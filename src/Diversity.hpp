@@ -0,0 +1,52 @@
+// src/Diversity.hpp
+// AutomaticMacroMaker - keeping several substantially different solutions
+// Developer: entity12208
+//
+// A timeline that is valid in the physics clone can still die in the engine. Rather
+// than searching again, the solver can keep going after the first solution and collect
+// a few more, so a fallback is ready immediately. Two timelines are compared by their
+// press ticks (the ticks where the button goes down): a press in one timeline counts
+// as matched if the other has a press within a couple of ticks of it. Solutions that
+// share almost every press would most likely fail in the engine the same way, so a new
+// one is only kept if enough of its presses differ from every solution already kept.
+
+#pragma once
+
+#include "Segment.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+// Ticks at which the button goes from released to held, in order.
+std::vector<uint32_t> pressTicks(const Timeline& inputs);
+
+// Presses of either list with no press of the other list within `slack` ticks.
+size_t pressDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, uint32_t slack);
+
+class SolutionSet {
+public:
+    static constexpr uint32_t PRESS_SLACK = 2;
+
+    // Keeps up to `capacity` timelines whose press distance to each other is at least
+    // `minFraction` of the larger press count (and at least one press).
+    SolutionSet(size_t capacity, float minFraction);
+
+    // Returns true if the timeline was kept.
+    bool offer(const Timeline& inputs);
+
+    bool full() const { return m_solutions.size() >= m_capacity; }
+    bool empty() const { return m_solutions.empty(); }
+    size_t rejected() const { return m_rejected; }
+    const std::vector<Timeline>& solutions() const { return m_solutions; }
+
+private:
+    size_t m_capacity;
+    float m_minFraction;
+    size_t m_rejected = 0;
+    std::vector<Timeline> m_solutions;
+    std::vector<std::vector<uint32_t>> m_presses;
+};
+
+} // namespace amm
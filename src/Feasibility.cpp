@@ -0,0 +1,183 @@
+// src/Feasibility.cpp
+// AutomaticMacroMaker - fast pre-solve check for levels no search can finish
+// Developer: entity12208
+
+#include "Feasibility.hpp"
+#include "Physics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+namespace {
+struct Span {
+    float lo, hi;
+};
+}
+
+// Room for float rounding in the collision kernels around `v`, so the scan never calls
+// a position blocked that the physics would let through.
+static float slack(float v) { return 0.01f + std::fabs(v) * 1.0e-6f; }
+
+// Y range of the convex polygon (xs, ys) between x = left and x = right; false if the
+// polygon misses that slab.
+static bool polygonSpan(const float* xs, const float* ys, int n, float left, float right, Span& out) {
+    out = {1.0e9f, -1.0e9f};
+    auto add = [&](float y) {
+        out.lo = std::min(out.lo, y);
+        out.hi = std::max(out.hi, y);
+    };
+    for (int i = 0; i < n; ++i) {
+        float x0 = xs[i], y0 = ys[i], x1 = xs[(i + 1) % n], y1 = ys[(i + 1) % n];
+        if (x0 >= left && x0 <= right) add(y0);
+        for (float c : {left, right})
+            if ((x0 < c) != (x1 < c)) add(y0 + (y1 - y0) * (c - x0) / (x1 - x0));
+    }
+    return out.lo <= out.hi;
+}
+
+// Y range a fatal shape covers between x = left and x = right; false if it is not
+// fatal or misses that slab.
+static bool fatalSpan(const LevelSnapshot& level, ShapeFamily family, uint32_t i, float left, float right,
+                      Span& out) {
+    switch (family) {
+        case ShapeFamily::Box: {
+            const BoxSet& b = level.boxes;
+            if (b.kind[i] != HitKind::Hazard || b.maxX[i] < left || b.minX[i] > right) return false;
+            out = {b.minY[i], b.maxY[i]};
+            return true;
+        }
+        case ShapeFamily::OrientedBox: {
+            const OrientedBoxSet& o = level.orientedBoxes;
+            if (o.kind[i] != HitKind::Hazard) return false;
+            float ux = o.cosA[i] * o.hx[i], uy = o.sinA[i] * o.hx[i];
+            float vx = -o.sinA[i] * o.hy[i], vy = o.cosA[i] * o.hy[i];
+            const float xs[4] = {o.cx[i] + ux + vx, o.cx[i] - ux + vx, o.cx[i] - ux - vx, o.cx[i] + ux - vx};
+            const float ys[4] = {o.cy[i] + uy + vy, o.cy[i] - uy + vy, o.cy[i] - uy - vy, o.cy[i] + uy - vy};
+            return polygonSpan(xs, ys, 4, left, right, out);
+        }
+        case ShapeFamily::Triangle: {
+            const TriangleSet& t = level.triangles;
+            if (t.kind[i] != HitKind::Hazard) return false;
+            const float xs[3] = {t.ax[i], t.bx[i], t.cx[i]};
+            const float ys[3] = {t.ay[i], t.by[i], t.cy[i]};
+            return polygonSpan(xs, ys, 3, left, right, out);
+        }
+        case ShapeFamily::Circle: {
+            const CircleSet& c = level.circles;
+            if (c.kind[i] != HitKind::Hazard && c.kind[i] != HitKind::Solid) return false;
+            float dx = c.cx[i] - std::clamp(c.cx[i], left, right);
+            float chord = c.r[i] * c.r[i] - dx * dx;
+            if (chord <= 0.0f) return false;
+            out = {c.cy[i] - std::sqrt(chord), c.cy[i] + std::sqrt(chord)};
+            return true;
+        }
+    }
+    return false;
+}
+
+// Removes the open range (lo, hi) from the sorted, disjoint closed spans.
+static void cut(std::vector<Span>& spans, float lo, float hi, std::vector<Span>& scratch) {
+    if (lo >= hi) return;
+    scratch.clear();
+    for (const Span& s : spans) {
+        if (s.lo <= lo) scratch.push_back({s.lo, std::min(s.hi, lo)});
+        if (s.hi >= hi) scratch.push_back({std::max(s.lo, hi), s.hi});
+    }
+    spans.swap(scratch);
+}
+
+Feasibility scanFeasibility(const LevelSnapshot& level, const Broadphase& broadphase, float dt,
+                            const std::vector<UnsupportedObject>& unsupported) {
+    Feasibility result;
+    if (level.sections.empty()) return result;
+
+    // Unsupported objects by the X where a hitbox can first reach them; `near` holds
+    // those the hitbox can overlap in X this tick.
+    std::vector<const UnsupportedObject*> pending, near;
+    for (const UnsupportedObject& u : unsupported)
+        if (u.x + u.halfWidth >= level.startX && u.x - u.halfWidth < level.endX) pending.push_back(&u);
+    std::sort(pending.begin(), pending.end(), [](const UnsupportedObject* a, const UnsupportedObject* b) {
+        return a->x - a->halfWidth < b->x - b->halfWidth;
+    });
+    size_t nextPending = 0;
+
+    PlayerState s = initialState(level);
+    float x = s.x;
+    size_t section = s.section;
+    std::vector<Span> reach{{s.y, s.y}}, scratch;
+    ShapeList candidates, contacts;
+
+    while (x < level.endX) {
+        bool entered = false;
+        while (section + 1 < level.sections.size() && x >= level.sections[section + 1].startX) {
+            section++;
+            entered = true;
+        }
+        const Section& sec = level.sections[section];
+        float half = modeParams(sec.mode).halfSize;
+        float floorY = sec.floorY + half, ceilY = std::max(floorY, sec.ceilY - half);
+        float fromX = x;
+        x += sec.speed * dt;
+        result.ticks++;
+
+        // Where the player can be when hazards are tested this tick.
+        if (entered || sec.mode == Gamemode::Spider) {
+            reach.assign(1, {floorY, ceilY});
+        } else {
+            float grow = maxTickDeltaY(sec.speed, dt);
+            scratch.clear();
+            for (const Span& r : reach) {
+                Span g{std::clamp(r.lo - grow, floorY, ceilY), std::clamp(r.hi + grow, floorY, ceilY)};
+                if (!scratch.empty() && g.lo <= scratch.back().hi) scratch.back().hi = std::max(scratch.back().hi, g.hi);
+                else scratch.push_back(g);
+            }
+            reach.swap(scratch);
+        }
+
+        // Cut out every Y where the hitbox overlaps something fatal. Only shapes reaching
+        // strictly inside the hitbox's X range count, and the cut keeps clear of rounding.
+        float left = x - half + slack(x), right = x + half - slack(x);
+        findContacts(level, broadphase, {x - half, reach.front().lo - half, x + half, reach.back().hi + half},
+                     candidates, contacts);
+        auto cutFamily = [&](ShapeFamily family, const std::vector<uint32_t>& indices) {
+            for (uint32_t i : indices) {
+                Span fatal;
+                if (!fatalSpan(level, family, i, left, right, fatal)) continue;
+                float edge = slack(std::max(std::fabs(fatal.lo), std::fabs(fatal.hi)));
+                cut(reach, fatal.lo - half + edge, fatal.hi + half - edge, scratch);
+            }
+        };
+        cutFamily(ShapeFamily::Box, contacts.boxes);
+        cutFamily(ShapeFamily::OrientedBox, contacts.orientedBoxes);
+        cutFamily(ShapeFamily::Triangle, contacts.triangles);
+        cutFamily(ShapeFamily::Circle, contacts.circles);
+
+        if (reach.empty()) {
+            result.feasible = false;
+            result.x = x;
+            result.reason = "hazards block every path";
+            return result;
+        }
+
+        // Unsupported objects the hitbox can overlap, swept from the last tick, with a
+        // Y range some path can be at.
+        while (nextPending < pending.size() && pending[nextPending]->x - pending[nextPending]->halfWidth <= x + half)
+            near.push_back(pending[nextPending++]);
+        std::erase_if(near, [&](const UnsupportedObject* u) { return u->x + u->halfWidth < fromX - half; });
+        for (const UnsupportedObject* u : near) {
+            float lo = u->y - u->halfHeight - half, hi = u->y + u->halfHeight + half;
+            for (const Span& r : reach) {
+                if (r.hi < lo || r.lo > hi) continue;
+                result.feasible = false;
+                result.x = u->x;
+                result.reason = std::string("unsupported ") + u->what;
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace amm
@@ -0,0 +1,43 @@
+// src/Feasibility.hpp
+// AutomaticMacroMaker - fast pre-solve check for levels no search can finish
+// Developer: entity12208
+//
+// A level the solver cannot finish used to cost the whole timeout before it said so.
+// scanFeasibility() runs before the search, in milliseconds, and stops at the first X
+// where the level is out of reach. The player's X at every tick is known in advance (it
+// only depends on the section speeds), so the scan walks the ticks keeping an envelope
+// of the Y the player can be at, widened by maxTickDeltaY (Physics.hpp) per tick,
+// clamped to the section and cut by the Y ranges where the hitbox would overlap a
+// hazard. It stops at
+//  - a hazard wall: once the envelope is empty no input sequence gets past that tick;
+//  - an object the physics clone does not model (noted at compile time, see
+//    CompiledLevel::unsupported) that the envelope reaches: the search cannot tell
+//    whether a path touches it, and one that does would play differently in the engine.
+//    Objects no path can touch, such as an orb far off the route, are ignored.
+// The envelope only over-approximates where the player can be, so the scan never
+// rejects a level that has a solution; it restarts at every section change and stays
+// full in spider sections (teleports). Solids are ignored, which only keeps it wider.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "CompiledLevel.hpp"
+#include "LevelSnapshot.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace amm {
+
+struct Feasibility {
+    bool feasible = true;
+    float x = 0.0f;      // where the level becomes impossible
+    std::string reason;  // "unsupported mini portal", "hazards block every path"
+    size_t ticks = 0;    // ticks scanned
+};
+
+Feasibility scanFeasibility(const LevelSnapshot& level, const Broadphase& broadphase, float dt,
+                            const std::vector<UnsupportedObject>& unsupported = {});
+
+} // namespace amm
@@ -0,0 +1,315 @@
+// src/FlightGrid.cpp
+// AutomaticMacroMaker - dense grid dynamic programming for flying sections
+// Developer: entity12208
+
+#include "DeltaPlane.hpp"
+#include "FlightGrid.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+static constexpr float CELL_Y = 1.0f;         // world units per Y cell
+static constexpr float CELL_VY = 16.0f;       // units/s per velocity cell
+static constexpr size_t MAX_WIDTH = 1u << 15; // occupied cells kept per tick (fits the 16-bit back pointers)
+
+static constexpr uint8_t FLAG_HELD = 1;
+static constexpr uint8_t FLAG_FLIPPED = 2;
+static constexpr uint8_t FLAG_GROUND = 4;
+
+bool flightGridHandles(Gamemode mode) {
+    return mode == Gamemode::Ship || mode == Gamemode::Ufo || mode == Gamemode::Wave || mode == Gamemode::Swing;
+}
+
+namespace {
+
+// Representative states of one tick, structure-of-arrays.
+struct Layer {
+    std::vector<float> y, vy;
+    std::vector<uint8_t> flags;
+    std::vector<uint32_t> lastInteract;
+    std::vector<uint16_t> back; // parent index << 1 | input
+
+    size_t size() const { return y.size(); }
+    void clear() { y.clear(); vy.clear(); flags.clear(); lastInteract.clear(); back.clear(); }
+};
+
+// Velocity change for one (held, flipped) group and one input, mirroring the input
+// and integration part of stepPlayer for the flying modes.
+struct Transform {
+    bool resetVy = false;
+    float resetTo = 0.0f;
+    float dv = 0.0f;
+    float lo = -1.0e9f, hi = 1.0e9f;
+    uint8_t flags = 0;
+};
+
+Transform transformFor(const PlayerState& tmpl, uint8_t flags, bool hold, float dt) {
+    const ModeParams& p = modeParams(tmpl.mode);
+    bool held = flags & FLAG_HELD;
+    bool flipped = flags & FLAG_FLIPPED;
+    bool pressed = hold && !held;
+    float up = flipped ? -1.0f : 1.0f;
+
+    Transform t;
+    switch (tmpl.mode) {
+        case Gamemode::Ship:
+            t.dv = (hold ? SHIP_THRUST : -p.gravity) * up * dt;
+            break;
+        case Gamemode::Ufo:
+            if (pressed) { t.resetVy = true; t.resetTo = p.jumpVelocity * up; }
+            t.dv = -(p.gravity * up * dt);
+            break;
+        case Gamemode::Swing:
+            if (pressed) flipped = !flipped;
+            up = flipped ? -1.0f : 1.0f;
+            t.dv = -(p.gravity * up * dt);
+            break;
+        default: // Wave
+            t.resetVy = true;
+            t.resetTo = (hold ? 1.0f : -1.0f) * up * tmpl.speed;
+            break;
+    }
+    if (tmpl.mode != Gamemode::Wave) {
+        t.lo = -p.maxFall;
+        t.hi = p.maxFall;
+    }
+    t.flags = (hold ? FLAG_HELD : 0) | (flipped ? FLAG_FLIPPED : 0);
+    return t;
+}
+
+template <class L>
+void integrate(const Transform& t, const float* y, const float* vy, float* outY, float* outVy, size_t n, float dt) {
+    const auto dv = L::splat(t.dv), lo = L::splat(t.lo), hi = L::splat(t.hi);
+    const auto reset = L::splat(t.resetTo), dtv = L::splat(dt);
+    for (size_t i = 0; i < n; i += 4) {
+        auto v = t.resetVy ? reset : L::load(vy + i);
+        v = L::max(lo, L::min(L::add(v, dv), hi));
+        L::store(outVy + i, v);
+        L::store(outY + i, L::add(L::load(y + i), L::mul(v, dtv)));
+    }
+}
+
+} // namespace
+
+std::vector<SegmentResult> solveFlightGrid(const LevelSnapshot& level, const Broadphase& broadphase,
+                                           const PlayerState& entry, float goalX, float dt, int maxTicks,
+                                           const Deadline& deadline, size_t maxResults,
+                                           FlightGridStats* stats) {
+    std::vector<SegmentResult> results;
+    FlightGridStats local;
+
+    // The first tick always goes through stepPlayer: it applies the section entry
+    // (mode, speed, gravity portal), after which those stay fixed for the section.
+    PlayerState tmpl = entry;
+    std::vector<PlayerState> firstStates;
+    std::vector<uint8_t> firstInputs;
+    for (int input = 0; input < 2; ++input) {
+        PlayerState s = entry;
+        auto outcome = stepPlayer(level, broadphase, s, input != 0, dt);
+        local.slowSteps++;
+        if (outcome == StepOutcome::Dead) continue;
+        firstStates.push_back(s);
+        firstInputs.push_back((uint8_t)input);
+    }
+    if (firstStates.empty()) return results;
+    tmpl = firstStates.front();
+    if (!flightGridHandles(tmpl.mode)) return results;
+
+    const Section& sec = level.sections[tmpl.section];
+    const ModeParams& p = modeParams(tmpl.mode);
+    const float half = p.halfSize;
+    const float vRange = tmpl.mode == Gamemode::Wave ? tmpl.speed + CELL_VY : p.maxFall + CELL_VY;
+    const size_t yBins = (size_t)std::ceil((sec.ceilY - sec.floorY) / CELL_Y) + 1;
+    const size_t vBins = (size_t)std::ceil(2.0f * vRange / CELL_VY) + 1;
+    if (sec.ceilY > 1.0e5f || yBins * vBins > (1u << 24)) return results; // no bounded corridor
+
+    std::vector<uint64_t> occupied((yBins * vBins * 4 + 63) / 64);
+    std::vector<uint8_t> blocked(yBins);
+    std::vector<DeltaPlane> backPlanes;
+    Layer cur, next;
+
+    auto insert = [&](Layer& layer, const PlayerState& s, uint32_t parent, int input) {
+        long yb = std::clamp((long)std::floor((s.y - sec.floorY) / CELL_Y), 0L, (long)yBins - 1);
+        long vb = std::clamp((long)std::floor((s.vy + vRange) / CELL_VY), 0L, (long)vBins - 1);
+        uint8_t fl = (s.held ? FLAG_HELD : 0) | (s.flipped ? FLAG_FLIPPED : 0);
+        size_t cell = (((size_t)yb * vBins + (size_t)vb) << 2) | fl;
+        uint64_t bit = 1ull << (cell & 63);
+        if ((occupied[cell >> 6] & bit) || layer.size() >= MAX_WIDTH) return;
+        occupied[cell >> 6] |= bit;
+        layer.y.push_back(s.y);
+        layer.vy.push_back(s.vy);
+        layer.flags.push_back(fl | (s.onGround ? FLAG_GROUND : 0));
+        layer.lastInteract.push_back(s.lastInteract);
+        layer.back.push_back((uint16_t)((parent << 1) | (uint32_t)input));
+    };
+    auto stateAt = [&](const Layer& layer, size_t i, float x) {
+        PlayerState s = tmpl;
+        s.x = x;
+        s.y = layer.y[i];
+        s.vy = layer.vy[i];
+        s.held = layer.flags[i] & FLAG_HELD;
+        s.flipped = layer.flags[i] & FLAG_FLIPPED;
+        s.onGround = layer.flags[i] & FLAG_GROUND;
+        s.lastInteract = layer.lastInteract[i];
+        return s;
+    };
+
+    // Back pointers are kept delta-packed (DeltaPlane.hpp); only the two live layers
+    // hold full states.
+    auto keepBackPlane = [&](const Layer& layer) {
+        backPlanes.emplace_back(layer.back);
+        local.planeBytes += backPlanes.back().bytes();
+        local.rawPlaneBytes += layer.back.size() * sizeof(uint16_t);
+    };
+    for (size_t i = 0; i < firstStates.size(); ++i) insert(cur, firstStates[i], 0, firstInputs[i]);
+    keepBackPlane(cur);
+    float x = tmpl.x;
+
+    // Scratch for the vectorized pass, padded to a multiple of four.
+    std::vector<float> gy, gvy, oy, ovy;
+    std::vector<uint32_t> gidx;
+    ShapeList candidates;
+    const bool native = simd::activeBackend() != simd::Backend::Scalar;
+
+    bool reachedGoal = x >= goalX || x >= level.endX;
+    for (int tick = 1; tick < maxTicks && !reachedGoal; ++tick) {
+        if ((tick & 7) == 0 && deadline.expired()) break;
+
+        // stepPlayer advances x the same way for every state of the tick.
+        float nextX = x + tmpl.speed * dt;
+
+        // Rasterize everything in the column (and the corridor edges) into blocked Y
+        // cells; states landing in a free cell cannot touch anything this tick.
+        std::fill(blocked.begin(), blocked.end(), 0);
+        auto block = [&](float lo, float hi) {
+            long b0 = std::max(0L, (long)std::floor((lo - sec.floorY) / CELL_Y));
+            long b1 = std::min((long)yBins - 1, (long)std::floor((hi - sec.floorY) / CELL_Y));
+            for (long b = b0; b <= b1; ++b) blocked[b] = 1;
+        };
+        block(sec.floorY - 1.0e4f, sec.floorY + half + CELL_Y);
+        block(sec.ceilY - half - CELL_Y, sec.ceilY + 1.0e4f);
+        candidates.clear();
+        broadphase.query({nextX - half, sec.floorY, nextX + half, sec.ceilY}, candidates);
+        const std::vector<uint32_t>* families[4] = {&candidates.boxes, &candidates.orientedBoxes,
+                                                    &candidates.triangles, &candidates.circles};
+        for (int f = 0; f < 4; ++f) {
+            for (uint32_t i : *families[f]) {
+                Aabb bounds = shapeBounds(level, (ShapeFamily)f, i);
+                block(bounds.minY - half - CELL_Y, bounds.maxY + half + CELL_Y);
+            }
+        }
+        auto isFree = [&](float y) {
+            float b = std::floor((y - sec.floorY) / CELL_Y);
+            return b >= 0.0f && b < (float)yBins && !blocked[(size_t)b];
+        };
+
+        std::fill(occupied.begin(), occupied.end(), 0);
+        next.clear();
+
+        auto slowStep = [&](uint32_t i, int input) {
+            PlayerState s = stateAt(cur, i, x);
+            auto outcome = stepPlayer(level, broadphase, s, input != 0, dt);
+            local.slowSteps++;
+            if (outcome != StepOutcome::Dead) insert(next, s, i, input);
+        };
+
+        // States touching something (ground contact, an orb/pad) always take the slow path.
+        for (uint8_t group = 0; group < 4; ++group) {
+            gidx.clear();
+            for (uint32_t i = 0; i < cur.size(); ++i) {
+                bool touching = (cur.flags[i] & FLAG_GROUND) || cur.lastInteract[i] != 0;
+                if ((cur.flags[i] & 3) == group && !touching) gidx.push_back(i);
+            }
+            if (gidx.empty()) continue;
+
+            size_t padded = (gidx.size() + 3) & ~size_t(3);
+            gy.assign(padded, 0.0f);
+            gvy.assign(padded, 0.0f);
+            oy.resize(padded);
+            ovy.resize(padded);
+            for (size_t k = 0; k < gidx.size(); ++k) {
+                gy[k] = cur.y[gidx[k]];
+                gvy[k] = cur.vy[gidx[k]];
+            }
+
+            for (int input = 0; input < 2; ++input) {
+                Transform t = transformFor(tmpl, group, input != 0, dt);
+                if (native) integrate<simd::NativeLanes>(t, gy.data(), gvy.data(), oy.data(), ovy.data(), padded, dt);
+                else integrate<simd::ScalarLanes>(t, gy.data(), gvy.data(), oy.data(), ovy.data(), padded, dt);
+
+                for (size_t k = 0; k < gidx.size(); ++k) {
+                    if (!isFree(oy[k])) {
+                        slowStep(gidx[k], input);
+                        continue;
+                    }
+                    PlayerState s = tmpl;
+                    s.x = nextX;
+                    s.y = oy[k];
+                    s.vy = ovy[k];
+                    s.held = t.flags & FLAG_HELD;
+                    s.flipped = t.flags & FLAG_FLIPPED;
+                    s.onGround = false;
+                    s.lastInteract = 0;
+                    insert(next, s, gidx[k], input);
+                    local.fastSteps++;
+                }
+            }
+        }
+        for (uint32_t i = 0; i < cur.size(); ++i) {
+            if ((cur.flags[i] & FLAG_GROUND) || cur.lastInteract[i] != 0) {
+                slowStep(i, 0);
+                slowStep(i, 1);
+            }
+        }
+
+        if (next.size() == 0) break;
+        local.peakWidth = std::max(local.peakWidth, (uint32_t)next.size());
+        local.ticks++;
+        keepBackPlane(next);
+        std::swap(cur, next);
+        x = nextX;
+        reachedGoal = x >= goalX || x >= level.endX;
+    }
+
+    if (reachedGoal) {
+        // Rebuild a spread of final states and replay each through stepPlayer.
+        size_t picks = std::min(maxResults, cur.size());
+        for (size_t k = 0; k < picks; ++k) {
+            size_t idx = k * cur.size() / picks;
+            Timeline inputs(backPlanes.size());
+            for (size_t layer = backPlanes.size(); layer-- > 0;) {
+                uint16_t bp = backPlanes[layer].at(idx);
+                inputs[layer] = bp & 1;
+                idx = bp >> 1;
+            }
+
+            SegmentResult r;
+            PlayerState s = entry;
+            StepOutcome outcome = StepOutcome::Alive;
+            for (uint8_t hold : inputs) {
+                outcome = stepPlayer(level, broadphase, s, hold != 0, dt);
+                if (outcome != StepOutcome::Alive) break;
+            }
+            if (outcome == StepOutcome::Dead || (outcome == StepOutcome::Alive && s.x < goalX)) continue;
+            r.inputs = std::move(inputs);
+            r.exit = s;
+            r.finished = outcome == StepOutcome::Finished;
+            results.push_back(std::move(r));
+        }
+    }
+
+    if (stats) {
+        stats->fastSteps += local.fastSteps;
+        stats->slowSteps += local.slowSteps;
+        stats->peakWidth = std::max(stats->peakWidth, local.peakWidth);
+        stats->ticks += local.ticks;
+        stats->planeBytes += local.planeBytes;
+        stats->rawPlaneBytes += local.rawPlaneBytes;
+    }
+    return results;
+}
+
+} // namespace amm
@@ -0,0 +1,42 @@
+// src/FlightGrid.hpp
+// AutomaticMacroMaker - dense grid dynamic programming for flying sections
+// Developer: entity12208
+//
+// Ship / UFO / wave / swing sections have a tiny state (Y, Y-velocity, two input bits)
+// and every state in a tick shares the same X. Instead of a tree search with a hashed
+// visited set, reachability is propagated one tick at a time over a dense grid of
+// (Y, vY, held, flipped) cells: each cell keeps one exact representative state, the
+// states of a tick are integrated four at a time (Simd.hpp), and only states near
+// geometry go through the full stepPlayer. A single back-pointer plane per tick is
+// kept, delta-packed (DeltaPlane.hpp), to rebuild the inputs; the result is replayed
+// through stepPlayer before it is returned, so grid merging can lose solutions but
+// never produce a wrong one.
+
+#pragma once
+
+#include "Segment.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+struct FlightGridStats {
+    uint64_t fastSteps = 0;  // states advanced by the vectorized integrator
+    uint64_t slowSteps = 0;  // states advanced by stepPlayer (near geometry)
+    uint32_t peakWidth = 0;  // most occupied cells in a single tick
+    uint32_t ticks = 0;
+    uint64_t planeBytes = 0;    // back-pointer planes as stored (delta-packed)
+    uint64_t rawPlaneBytes = 0; // the same planes at 16 bits per entry
+};
+
+bool flightGridHandles(Gamemode mode);
+
+// Propagates reachability from `entry` until goalX. Returns up to maxResults verified
+// exits, spread across the final tick's occupied cells (empty if none survive).
+std::vector<SegmentResult> solveFlightGrid(const LevelSnapshot& level, const Broadphase& broadphase,
+                                           const PlayerState& entry, float goalX, float dt, int maxTicks,
+                                           const Deadline& deadline, size_t maxResults,
+                                           FlightGridStats* stats = nullptr);
+
+} // namespace amm
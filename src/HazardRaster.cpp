@@ -0,0 +1,71 @@
+// src/HazardRaster.cpp
+// AutomaticMacroMaker - coarse occupancy raster of everything that can kill or block
+// Developer: entity12208
+
+#include "HazardRaster.hpp"
+#include "Collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+void HazardRaster::build(const LevelSnapshot& level) {
+    const size_t counts[4] = {level.boxes.size(), level.orientedBoxes.size(),
+                              level.triangles.size(), level.circles.size()};
+    const std::vector<HitKind>* kinds[4] = {&level.boxes.kind, &level.orientedBoxes.kind,
+                                            &level.triangles.kind, &level.circles.kind};
+
+    float minX = level.startX, maxX = std::max(level.endX, level.startX), minY = 0.0f, maxY = 0.0f;
+    bool any = false;
+    for (int f = 0; f < 4; ++f) {
+        for (uint32_t i = 0; i < counts[f]; ++i) {
+            if (isPad((*kinds[f])[i]) || isOrb((*kinds[f])[i])) continue;
+            Aabb b = shapeBounds(level, (ShapeFamily)f, i);
+            minX = std::min(minX, b.minX);
+            maxX = std::max(maxX, b.maxX);
+            minY = any ? std::min(minY, b.minY) : b.minY;
+            maxY = any ? std::max(maxY, b.maxY) : b.maxY;
+            any = true;
+        }
+    }
+
+    m_originX = std::floor(minX / CELL) * CELL;
+    m_originY = std::floor(minY / CELL) * CELL;
+    m_columns = (int)std::ceil((maxX - m_originX) / CELL) + 1;
+    m_rows = std::clamp((int)std::ceil((maxY - m_originY) / CELL) + 1, 1, MAX_ROWS);
+    m_words = (m_rows + 63) / 64;
+    m_bits.assign((size_t)m_columns * m_words, 0);
+
+    for (int f = 0; f < 4; ++f) {
+        for (uint32_t i = 0; i < counts[f]; ++i) {
+            if (isPad((*kinds[f])[i]) || isOrb((*kinds[f])[i])) continue;
+            Aabb b = shapeBounds(level, (ShapeFamily)f, i);
+            mark(b.minX, b.minY, b.maxX, b.maxY);
+        }
+    }
+}
+
+void HazardRaster::mark(float minX, float minY, float maxX, float maxY) {
+    int c0 = std::max(columnOf(minX), 0), c1 = std::min(columnOf(maxX), m_columns - 1);
+    int r0 = std::max(rowOf(minY), 0), r1 = std::min(rowOf(maxY), m_rows - 1);
+    for (int c = c0; c <= c1; ++c) {
+        uint64_t* column = &m_bits[(size_t)c * m_words];
+        for (int r = r0; r <= r1; ++r) column[r >> 6] |= 1ull << (r & 63);
+    }
+}
+
+bool HazardRaster::blocked(int col, int row) const {
+    if (col < 0 || col >= m_columns || row < 0 || row >= m_rows) return false;
+    return (m_bits[(size_t)col * m_words + (row >> 6)] >> (row & 63)) & 1;
+}
+
+int HazardRaster::columnOf(float x) const {
+    return (int)std::floor((x - m_originX) / CELL);
+}
+
+int HazardRaster::rowOf(float y) const {
+    return (int)std::floor((y - m_originY) / CELL);
+}
+
+} // namespace amm
@@ -0,0 +1,43 @@
+// src/HazardRaster.hpp
+// AutomaticMacroMaker - coarse occupancy raster of everything that can kill or block
+// Developer: entity12208
+//
+// Heuristics want to know "how much room is around the player" many times per search
+// step, which is far too often for a broadphase query. The raster answers it with a
+// few bit tests: the level is cut into CELL x CELL squares and every square touched by
+// the bounds of a solid or hazard is marked. Pads and orbs are left out. The raster is
+// conservative (bounds, not exact shapes) and never used for collision itself.
+
+#pragma once
+
+#include "LevelSnapshot.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+class HazardRaster {
+public:
+    static constexpr float CELL = 30.0f;
+    static constexpr int MAX_ROWS = 1024;
+
+    void build(const LevelSnapshot& level);
+
+    // Out-of-range cells are free.
+    bool blocked(int col, int row) const;
+    int columnOf(float x) const;
+    int rowOf(float y) const;
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+
+private:
+    void mark(float minX, float minY, float maxX, float maxY);
+
+    float m_originX = 0.0f, m_originY = 0.0f;
+    int m_columns = 0, m_rows = 0, m_words = 0;
+    std::vector<uint64_t> m_bits; // m_words per column, bit r = row r blocked
+};
+
+} // namespace amm
@@ -0,0 +1,243 @@
+// src/HorizonStrategy.cpp
+// AutomaticMacroMaker - receding-horizon planner: solve a few seconds ahead, commit one
+// Developer: entity12208
+//
+// Instead of a plan for the whole level, each step solves a window of WINDOW_SECONDS
+// ahead of the committed state and commits only the first COMMIT_SECONDS of the plan
+// (at most half of it). Flying windows use the flight grid; everything else, and any
+// window the grid fails, uses the lockstep tick search, so robust mode works the same
+// way. The rest of the plan is kept: the next window first replays it and only searches
+// on from where it ends, so most of every window's path is reused rather than searched
+// again. Failed windows are retried shorter or wider (see failed()); only the last
+// MAX_BACKTRACK committed chunks can be undone.
+//
+// Every window search has its own time cap, so the work per step and the search memory
+// stay bounded however long the level is; only the committed inputs grow with it.
+
+#include "FlightGrid.hpp"
+#include "Strategy.hpp"
+#include "TickSearch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+namespace amm {
+
+namespace {
+
+class HorizonStrategy final : public SolverStrategy {
+public:
+    static constexpr float WINDOW_SECONDS = 3.0f;
+    static constexpr float COMMIT_SECONDS = 1.0f;
+    static constexpr float MAX_WINDOW_SECONDS = 12.0f;
+    static constexpr int WINDOW_MS = 2000;      // time cap per window search, at first
+    static constexpr int MAX_WINDOW_MS = 32000;
+    static constexpr size_t MAX_BACKTRACK = 8;  // committed chunks that can be undone
+    static constexpr int TICK_SLACK = 2;
+
+    void prepare(const SolveContext& context) override {
+        m_ctx = context;
+        m_config = context.settings.robust ? MultiRateConfig::robust() : MultiRateConfig::single();
+        m_options.guide = context.settings.guide;
+        m_options.bitState = context.settings.bitState;
+        m_options.estimator = context.settings.estimator;
+        m_lanes = spreadLanes(initialState(*context.level), m_config);
+        m_startX = m_bestX = m_lanes.minX();
+        m_window = WINDOW_SECONDS;
+    }
+
+    bool step(uint64_t) override {
+        if (m_done) return false;
+        if (m_ctx.deadline.expired()) return finish();
+
+        const LevelSnapshot& level = *m_ctx.level;
+        float dt = m_ctx.settings.dt;
+        int windowTicks = (int)(m_window / dt);
+        float x = m_lanes.minX();
+        float goalX = std::min(level.endX, x + level.sections[level.sectionAt(x)].speed * windowTicks * dt);
+        // The window is a distance; the tick cap leaves room for speed changes inside it.
+        int maxTicks = std::min(m_ctx.settings.maxTicks, windowTicks * TICK_SLACK);
+
+        Deadline windowDeadline = m_ctx.deadline;
+        windowDeadline.at = std::min(windowDeadline.at,
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(m_windowMs));
+
+        // Reuse the uncommitted tail of the last plan when it still holds.
+        Timeline plan;
+        bool ok = false, finished = false;
+        if (!m_tail.empty()) {
+            LaneStates lanes = m_lanes;
+            StepOutcome outcome = replay(lanes, m_tail);
+            if (outcome != StepOutcome::Dead) {
+                plan = m_tail;
+                finished = outcome == StepOutcome::Finished;
+                ok = finished || lanes.minX() >= goalX || searchFrom(lanes, goalX, maxTicks, windowDeadline, plan, finished);
+                if (ok) m_reused++;
+            }
+        }
+        if (!ok) {
+            plan.clear();
+            ok = searchFrom(m_lanes, goalX, maxTicks, windowDeadline, plan, finished);
+        }
+        m_tail.clear();
+        if (!ok) return failed(windowDeadline.expired());
+
+        m_windows++;
+        if (finished) {
+            m_timeline.insert(m_timeline.end(), plan.begin(), plan.end());
+            m_solved = true;
+            m_bestX = level.endX;
+            return finish();
+        }
+
+        // Never commit more than half the plan, so what is committed was checked against
+        // at least as much again beyond it.
+        size_t commit = std::max<size_t>(1, std::min(plan.size() / 2, (size_t)(COMMIT_SECONDS / dt)));
+        m_marks.push_back({m_timeline.size(), m_lanes});
+        if (m_marks.size() > MAX_BACKTRACK) m_marks.pop_front();
+        Timeline chunk(plan.begin(), plan.begin() + (ptrdiff_t)commit);
+        replay(m_lanes, chunk);
+        m_timeline.insert(m_timeline.end(), chunk.begin(), chunk.end());
+        m_tail.assign(plan.begin() + (ptrdiff_t)commit, plan.end());
+        if (m_lanes.minX() > m_bestX) {
+            // New ground: the retries are used up only by failures that make no progress.
+            m_bestX = m_lanes.minX();
+            m_stuck = m_deadEnds = 0;
+            m_windowMs = WINDOW_MS;
+            m_window = m_window > WINDOW_SECONDS ? std::max(WINDOW_SECONDS, m_window * 0.5f)
+                                                 : std::min(WINDOW_SECONDS, m_window * 2.0f);
+        }
+        return true;
+    }
+
+    SolveProgress progress() const override {
+        SolveProgress p;
+        float span = m_ctx.level->endX - m_startX;
+        p.fraction = span > 0.0f ? std::clamp((m_bestX - m_startX) / span, 0.0f, 1.0f) : 1.0f;
+        p.work = m_stats.nodes + m_gridSteps;
+        p.solutions = m_solved ? 1 : 0;
+        p.memory = m_timeline.capacity() + m_tail.capacity() + m_marks.size() * sizeof(Mark);
+        return p;
+    }
+
+    std::vector<Timeline> extract() override {
+        if (!m_solved) return {};
+        return {m_timeline};
+    }
+
+    std::string report() const override {
+        return std::to_string(m_windows) + " windows, " + std::to_string(m_reused) + " reused plan tails, " +
+            std::to_string(m_backtracks) + " backtracks, " + std::to_string(m_gridSteps) + " grid steps, " +
+            std::to_string(m_stats.nodes) + " tick nodes, " +
+            std::to_string(m_stats.duplicates) + " duplicates, " + std::to_string(m_config.count) + " rate lanes" +
+            omissions(m_ctx.settings, m_stats) + probes(m_ctx.settings, m_stats);
+    }
+
+private:
+    // Timeline length and lanes before a committed chunk.
+    struct Mark {
+        size_t size;
+        LaneStates lanes;
+    };
+
+    StepOutcome replay(LaneStates& lanes, const Timeline& inputs) const {
+        StepOutcome outcome = StepOutcome::Alive;
+        for (uint8_t hold : inputs) {
+            outcome = stepLanes(*m_ctx.level, *m_ctx.broadphase, m_config, lanes, hold != 0, m_ctx.settings.dt);
+            if (outcome != StepOutcome::Alive) break;
+        }
+        return outcome;
+    }
+
+    // Appends the inputs from `from` to goalX to `plan`. Flying windows go through the
+    // flight grid first, cut at the section end since it only handles one gamemode; its
+    // exits are checked at every rate by replaying them.
+    bool searchFrom(const LaneStates& from, float goalX, int maxTicks, const Deadline& deadline, Timeline& plan,
+                    bool& finished) {
+        const LevelSnapshot& level = *m_ctx.level;
+        const SolverSettings& cfg = m_ctx.settings;
+        float x = from.minX();
+        if (flightGridHandles(level.sections[level.sectionAt(x)].mode)) {
+            float gridGoal = std::min(goalX, sectionGoalX(level, x));
+            uint64_t before = m_gridStats.fastSteps + m_gridStats.slowSteps;
+            std::vector<SegmentResult> candidates = solveFlightGrid(level, *m_ctx.broadphase, from.lane[0], gridGoal,
+                cfg.dt, maxTicks, deadline, cfg.maxSectionCandidates, &m_gridStats);
+            m_gridSteps += m_gridStats.fastSteps + m_gridStats.slowSteps - before;
+            for (const SegmentResult& c : candidates) {
+                LaneStates lanes = from;
+                StepOutcome outcome = replay(lanes, c.inputs);
+                if (outcome == StepOutcome::Dead || (outcome == StepOutcome::Alive && lanes.minX() < gridGoal)) continue;
+                plan.insert(plan.end(), c.inputs.begin(), c.inputs.end());
+                finished = outcome == StepOutcome::Finished;
+                return true;
+            }
+        }
+        SegmentResult r;
+        if (!searchTicksLockstep(level, *m_ctx.broadphase, m_config, from, goalX, cfg.dt, maxTicks, deadline, r,
+                &m_stats, m_options))
+            return false;
+        plan.insert(plan.end(), r.inputs.begin(), r.inputs.end());
+        finished = r.finished;
+        return true;
+    }
+
+    // No plan for the window from the committed state. A search that ran out of time
+    // gets a shorter window (any path to the far goal passes the near one, so that
+    // search is never harder) and twice the time, so hard stretches are still solved.
+    // A search that ran out of moves hit a dead end the committed inputs led into, so
+    // chunks are undone and the window widened to see past it. Gives up after
+    // MAX_BACKTRACK failures in a row without new ground, or with nothing left to try.
+    bool failed(bool timedOut) {
+        if (m_ctx.deadline.expired() || ++m_stuck > MAX_BACKTRACK) return finish();
+        if (timedOut) {
+            if (m_windowMs >= MAX_WINDOW_MS) return finish();
+            m_windowMs *= 2;
+            m_window = std::max(COMMIT_SECONDS, m_window * 0.5f);
+            return true;
+        }
+        if (m_marks.empty() && m_window >= MAX_WINDOW_SECONDS) return finish();
+        // Each dead end in a row undoes one chunk more than the last.
+        m_deadEnds++;
+        for (size_t i = 0; i < m_deadEnds && !m_marks.empty(); ++i) {
+            m_backtracks++;
+            m_timeline.resize(m_marks.back().size);
+            m_lanes = m_marks.back().lanes;
+            m_marks.pop_back();
+        }
+        m_window = std::min(MAX_WINDOW_SECONDS, m_window * 2.0f);
+        return true;
+    }
+
+    bool finish() {
+        m_done = true;
+        return false;
+    }
+
+    SolveContext m_ctx;
+    MultiRateConfig m_config;
+    TickSearchOptions m_options;
+    TickSearchStats m_stats;
+    FlightGridStats m_gridStats;
+    uint64_t m_gridSteps = 0;
+
+    LaneStates m_lanes;        // state after the committed inputs
+    Timeline m_timeline;       // committed inputs
+    Timeline m_tail;           // uncommitted rest of the last plan
+    std::deque<Mark> m_marks;  // most recent last
+    float m_window = WINDOW_SECONDS;
+    int m_windowMs = WINDOW_MS;
+    float m_startX = 0.0f, m_bestX = 0.0f;
+    bool m_done = false, m_solved = false;
+    size_t m_windows = 0, m_reused = 0, m_backtracks = 0;
+    size_t m_stuck = 0;         // failures since the committed X last advanced
+    size_t m_deadEnds = 0;      // of those, searches that ran out of moves
+};
+
+} // namespace
+
+std::unique_ptr<SolverStrategy> makeHorizonStrategy() {
+    return std::make_unique<HorizonStrategy>();
+}
+
+} // namespace amm
@@ -0,0 +1,160 @@
+// src/IdleSolver.cpp
+// AutomaticMacroMaker - levels solved in the background while the player is in menus
+// Developer: entity12208
+
+#include "IdleSolver.hpp"
+#include "Collision.hpp"
+#include "Feasibility.hpp"
+#include "Strategy.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace amm {
+
+static constexpr uint64_t STEP_BUDGET = 50000; // work units between cancellation checks
+
+// Lets the game and every other thread go first.
+static void lowerThreadPriority() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#elif defined(SCHED_IDLE)
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+
+IdleSolver::IdleSolver(const SolutionCache& cache, Settings settings, Listener listener)
+    : m_cache(cache), m_settings(std::move(settings)), m_listener(std::move(listener)) {
+    m_thread = std::thread([this] { run(); });
+}
+
+IdleSolver::~IdleSolver() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_cancel = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void IdleSolver::add(uint64_t key, LevelSnapshot level, std::vector<UnsupportedObject> unsupported) {
+    Job job;
+    job.key = key;
+    job.level = std::move(level);
+    job.unsupported = std::move(unsupported);
+    push(std::move(job));
+}
+
+void IdleSolver::add(uint64_t key, std::shared_ptr<const CompiledLevel> compiled, const LiveStart& start) {
+    Job job;
+    job.key = key;
+    job.compiled = std::move(compiled);
+    job.start = start;
+    push(std::move(job));
+}
+
+void IdleSolver::push(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [&](const Job& j) { return j.key == job.key; }),
+            m_queue.end());
+        m_queue.push_front(std::move(job));
+    }
+    m_wake.notify_all();
+}
+
+void IdleSolver::pause() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paused = true;
+    m_cancel = true;
+}
+
+void IdleSolver::resume() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = false;
+    }
+    m_wake.notify_all();
+}
+
+size_t IdleSolver::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void IdleSolver::run() {
+    lowerThreadPriority();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [&] { return m_stop || (!m_paused && !m_queue.empty()); });
+        if (m_stop) return;
+        Job job = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_cancel = false;
+        lock.unlock();
+        bool done = solve(job);
+        lock.lock();
+        if (!done && !m_stop) m_queue.push_front(std::move(job));
+    }
+}
+
+bool IdleSolver::solve(const Job& job) {
+    CorpusEntry entry;
+    if (m_cache.load(job.key, entry) && entry.solved) return true; // a press got there first
+
+    entry = {};
+    // The compiled pose stands in for the level start; a cached solution is checked on
+    // the live level before it is used anyway.
+    entry.level = job.compiled ? rebase(*job.compiled, job.compiled->compiledPose, job.start) : job.level;
+    const std::vector<UnsupportedObject>& unsupported = job.compiled ? job.compiled->unsupported : job.unsupported;
+    Broadphase broadphase;
+    broadphase.build(entry.level);
+    std::string report;
+    Feasibility scan;
+    if (m_settings.scan) scan = scanFeasibility(entry.level, broadphase, m_settings.dt, unsupported);
+    if (scan.feasible) {
+        SolveContext ctx;
+        ctx.level = &entry.level;
+        ctx.broadphase = &broadphase;
+        ctx.settings.dt = m_settings.dt;
+        ctx.settings.robust = m_settings.robust;
+        ctx.deadline.at = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_settings.timeoutMs);
+        ctx.deadline.cancel = &m_cancel;
+
+        std::unique_ptr<SolverStrategy> strategy = createStrategy(m_settings.strategy);
+        if (!strategy) strategy = strategies().front().create();
+        strategy->prepare(ctx);
+        while (strategy->step(STEP_BUDGET)) {}
+        if (m_cancel) return false;
+
+        std::vector<Timeline> solutions = strategy->extract();
+        entry.solved = !solutions.empty();
+        if (entry.solved) entry.solution = std::move(solutions.front());
+        report = strategy->report();
+    } else {
+        report = scan.reason;
+    }
+
+    m_cache.offer(job.key, entry); // a press may have stored a better one meanwhile
+    if (m_listener) m_listener(job.key, entry.solved, report);
+    return true;
+}
+
+} // namespace amm
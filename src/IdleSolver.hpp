@@ -0,0 +1,94 @@
+// src/IdleSolver.hpp
+// AutomaticMacroMaker - levels solved in the background while the player is in menus
+// Developer: entity12208
+//
+// With the idle pre-solve setting on, every level the player leaves after a press is
+// queued here as its compiled level and start, and one background thread at the lowest
+// scheduling priority rebases and solves the queue into the solution cache
+// (SolutionCache.hpp) while no level is being played. The next press on that level then
+// only has to check the cached solution. Levels that failed before are queued again at
+// startup as the snapshot they were stored with, newest first.
+//
+// pause() when a level starts: the running solve is cancelled through its deadline
+// within one strategy step and goes back to the front of the queue; resume() once the
+// player is back in the menus. Every call returns at once and may come from any thread.
+
+#pragma once
+
+#include "CompiledLevel.hpp"
+#include "LevelSnapshot.hpp"
+#include "SolutionCache.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace amm {
+
+class IdleSolver {
+public:
+    struct Settings {
+        std::string strategy = "sections";
+        bool robust = false;
+        bool scan = true; // run the feasibility scan first (Feasibility.hpp)
+        int timeoutMs = 120 * 1000; // per level
+        float dt = 1.0f / 60.0f;
+    };
+
+    // Called on the idle thread after each level it finishes: the level key, whether it
+    // was solved, and the strategy report (or why it was not searched).
+    using Listener = std::function<void(uint64_t key, bool solved, const std::string& report)>;
+
+    IdleSolver(const SolutionCache& cache, Settings settings, Listener listener = {});
+    // Cancels the running solve and waits for the thread.
+    ~IdleSolver();
+    IdleSolver(const IdleSolver&) = delete;
+    IdleSolver& operator=(const IdleSolver&) = delete;
+
+    // Queues `level`, a snapshot from the level start, in front of the others; an older
+    // request for the same key is dropped.
+    void add(uint64_t key, LevelSnapshot level, std::vector<UnsupportedObject> unsupported = {});
+    // Queues `compiled` rebased onto `start` (at its compiled pose); the rebase runs on
+    // the idle thread.
+    void add(uint64_t key, std::shared_ptr<const CompiledLevel> compiled, const LiveStart& start);
+    void pause();
+    void resume();
+
+    size_t pending() const;
+
+private:
+    struct Job {
+        uint64_t key = 0;
+        LevelSnapshot level;
+        std::vector<UnsupportedObject> unsupported;
+        std::shared_ptr<const CompiledLevel> compiled; // when set, rebased onto `start` instead
+        LiveStart start;
+    };
+
+    void push(Job job);
+
+    void run();
+    // False if cancelled.
+    bool solve(const Job& job);
+
+    const SolutionCache& m_cache;
+    Settings m_settings;
+    Listener m_listener;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_queue;
+    bool m_paused = false, m_stop = false;
+    std::atomic<bool> m_cancel{false};
+    std::thread m_thread;
+};
+
+} // namespace amm
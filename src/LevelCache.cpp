@@ -0,0 +1,80 @@
+// src/LevelCache.cpp
+// AutomaticMacroMaker - compiled levels kept across PlayLayers, least recently used first out
+// Developer: entity12208
+
+#include "LevelCache.hpp"
+#include "CollisionMemo.hpp"
+
+namespace amm {
+
+template <class T> static size_t vectorBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+static size_t snapshotBytes(const LevelSnapshot& l) {
+    const BoxSet& b = l.boxes;
+    const OrientedBoxSet& o = l.orientedBoxes;
+    const TriangleSet& t = l.triangles;
+    const CircleSet& c = l.circles;
+    return vectorBytes(b.minX) + vectorBytes(b.minY) + vectorBytes(b.maxX) + vectorBytes(b.maxY) +
+        vectorBytes(b.kind) + vectorBytes(o.cx) + vectorBytes(o.cy) + vectorBytes(o.hx) + vectorBytes(o.hy) +
+        vectorBytes(o.cosA) + vectorBytes(o.sinA) + vectorBytes(o.kind) + vectorBytes(t.ax) + vectorBytes(t.ay) +
+        vectorBytes(t.bx) + vectorBytes(t.by) + vectorBytes(t.cx) + vectorBytes(t.cy) + vectorBytes(t.kind) +
+        vectorBytes(c.cx) + vectorBytes(c.cy) + vectorBytes(c.r) + vectorBytes(c.kind) + vectorBytes(l.sections);
+}
+
+size_t CachedLevel::bytes() const {
+    size_t total = 0;
+    if (compiled)
+        total += snapshotBytes(compiled->level) + vectorBytes(compiled->dynamic) + vectorBytes(compiled->compiledPose) +
+            vectorBytes(compiled->objectIndex);
+    if (broadphase)
+        total += (broadphase->columnCount() + 1 + broadphase->entryCount()) * sizeof(uint32_t) +
+            broadphase->memo().bytes();
+    if (sections) total += sections->bytes;
+    return total;
+}
+
+void LevelCache::setBudget(size_t bytes) {
+    m_budget = bytes;
+    trim();
+}
+
+std::shared_ptr<CachedLevel> LevelCache::find(uint64_t key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        m_misses++;
+        return nullptr;
+    }
+    m_hits++;
+    m_order.splice(m_order.begin(), m_order, it->second);
+    return it->second->second;
+}
+
+void LevelCache::insert(uint64_t key, std::shared_ptr<CachedLevel> level) {
+    if (auto it = m_index.find(key); it != m_index.end()) {
+        m_order.erase(it->second);
+        m_index.erase(it);
+    }
+    m_order.emplace_front(key, std::move(level));
+    m_index[key] = m_order.begin();
+    trim();
+}
+
+void LevelCache::trim() {
+    size_t total = bytes();
+    while (total > m_budget && m_order.size() > 1) {
+        total -= m_order.back().second->bytes();
+        m_index.erase(m_order.back().first);
+        m_order.pop_back();
+        m_evictions++;
+    }
+}
+
+size_t LevelCache::bytes() const {
+    size_t total = 0;
+    for (const auto& [key, level] : m_order) total += level->bytes();
+    return total;
+}
+
+} // namespace amm
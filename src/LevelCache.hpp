@@ -0,0 +1,71 @@
+// src/LevelCache.hpp
+// AutomaticMacroMaker - compiled levels kept across PlayLayers, least recently used first out
+// Developer: entity12208
+//
+// Players go back and forth between practice, normal mode and the same level again,
+// and each new PlayLayer would otherwise compile the level from scratch. The glue keys
+// each compiled level by a hash of the level data and keeps it here together with what
+// later solves can reuse as long as the shapes have not moved:
+//  - the broadphase over the compiled shapes;
+//  - the section cache (Strategy.hpp), so sections solved before are not solved again.
+// Entries are evicted least recently used first once their total size passes the
+// budget. The cache itself is main-thread only; entries are shared_ptrs so a solve in
+// flight keeps what it uses alive even if its entry is evicted.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "CompiledLevel.hpp"
+#include "Strategy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace amm {
+
+struct CachedLevel {
+    std::shared_ptr<const CompiledLevel> compiled;
+    // Built from compiled->level; valid for requests whose rebase moved and switched off
+    // nothing. Null until the first such solve has built one.
+    std::shared_ptr<const Broadphase> broadphase;
+    // Lent to one solve at a time (null while lent), for the same requests as above.
+    std::shared_ptr<SectionCache> sections = std::make_shared<SectionCache>();
+
+    size_t bytes() const;
+};
+
+class LevelCache {
+public:
+    explicit LevelCache(size_t budgetBytes = 0) : m_budget(budgetBytes) {}
+
+    void setBudget(size_t bytes);
+
+    // The entry for `key`, now the most recently used one, or null.
+    std::shared_ptr<CachedLevel> find(uint64_t key);
+
+    // Adds (or replaces) the entry for `key`, then trims.
+    void insert(uint64_t key, std::shared_ptr<CachedLevel> level);
+
+    // Evicts least recently used entries until the total fits the budget; the most
+    // recent one always stays. Call after an entry has grown.
+    void trim();
+
+    size_t size() const { return m_order.size(); }
+    size_t bytes() const;
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+    size_t evictions() const { return m_evictions; }
+
+private:
+    using Entry = std::pair<uint64_t, std::shared_ptr<CachedLevel>>;
+
+    size_t m_budget;
+    std::list<Entry> m_order; // most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_index;
+    size_t m_hits = 0, m_misses = 0, m_evictions = 0;
+};
+
+} // namespace amm
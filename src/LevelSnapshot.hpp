@@ -0,0 +1,120 @@
+// src/LevelSnapshot.hpp
+// AutomaticMacroMaker - engine-free copy of the level the solver works on
+// Developer: entity12208
+//
+// The snapshot is made on the main thread, by rebasing the level compiled once per level
+// onto the live state (see CompiledLevel.hpp), and then handed to the background solver
+// by value. Nothing in here may reference engine
+// types: the solver thread must never touch PlayLayer / GameObject.
+//
+// Geometry is stored structure-of-arrays per shape family so the collision kernels
+// can stream four candidates at a time (see Collision.hpp).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace amm {
+
+enum class Gamemode : uint8_t { Cube, Ship, Ball, Ufo, Wave, Robot, Spider, Swing };
+
+// What touching a shape does to the player.
+enum class HitKind : uint8_t {
+    Solid,
+    Hazard,
+    YellowPad, PinkPad, RedPad, BluePad,
+    YellowOrb, PinkOrb, RedOrb, BlueOrb, GreenOrb, BlackOrb,
+};
+
+inline bool isPad(HitKind k) { return k >= HitKind::YellowPad && k <= HitKind::BluePad; }
+inline bool isOrb(HitKind k) { return k >= HitKind::YellowOrb && k <= HitKind::BlackOrb; }
+
+// Axis-aligned rectangles (regular blocks, spikes, pads, orbs).
+struct BoxSet {
+    std::vector<float> minX, minY, maxX, maxY;
+    std::vector<HitKind> kind;
+
+    size_t size() const { return kind.size(); }
+    void add(float x0, float y0, float x1, float y1, HitKind k) {
+        minX.push_back(x0); minY.push_back(y0); maxX.push_back(x1); maxY.push_back(y1); kind.push_back(k);
+    }
+};
+
+// Rotated rectangles: center, half extents and the rotation as cos/sin.
+struct OrientedBoxSet {
+    std::vector<float> cx, cy, hx, hy, cosA, sinA;
+    std::vector<HitKind> kind;
+
+    size_t size() const { return kind.size(); }
+    void add(float x, float y, float halfW, float halfH, float c, float s, HitKind k) {
+        cx.push_back(x); cy.push_back(y); hx.push_back(halfW); hy.push_back(halfH);
+        cosA.push_back(c); sinA.push_back(s); kind.push_back(k);
+    }
+};
+
+// Slopes and any other triangular hitbox.
+struct TriangleSet {
+    std::vector<float> ax, ay, bx, by, cx, cy;
+    std::vector<HitKind> kind;
+
+    size_t size() const { return kind.size(); }
+    void add(float x0, float y0, float x1, float y1, float x2, float y2, HitKind k) {
+        ax.push_back(x0); ay.push_back(y0); bx.push_back(x1); by.push_back(y1);
+        cx.push_back(x2); cy.push_back(y2); kind.push_back(k);
+    }
+};
+
+// Saws and other round hitboxes.
+struct CircleSet {
+    std::vector<float> cx, cy, r;
+    std::vector<HitKind> kind;
+
+    size_t size() const { return kind.size(); }
+    void add(float x, float y, float radius, HitKind k) {
+        cx.push_back(x); cy.push_back(y); r.push_back(radius); kind.push_back(k);
+    }
+};
+
+// A run of the level between two portals. Everything the player physics needs to
+// know about "where am I" lives here, so portals never have to be collision tested.
+struct Section {
+    float startX = 0.0f;
+    Gamemode mode = Gamemode::Cube;
+    float speed = 311.58f;          // units per second
+    float floorY = 90.0f;           // top of the ground / corridor floor
+    float ceilY = 1.0e6f;           // bottom of the corridor ceiling (effectively none for cube)
+    int8_t setGravity = -1;         // -1 keep, 0 normal, 1 flipped on entry
+};
+
+struct LevelSnapshot {
+    BoxSet boxes;
+    OrientedBoxSet orientedBoxes;
+    TriangleSet triangles;
+    CircleSet circles;
+
+    // Sorted by startX; sections[sectionAt(startX)] describes the player state at the
+    // snapshot point. Sections before it may be kept (see rebase, CompiledLevel.hpp).
+    std::vector<Section> sections;
+
+    float startX = 0.0f;
+    float startY = 105.0f;
+    float startVy = 0.0f;
+    bool startFlipped = false;
+    float endX = 0.0f;
+
+    size_t shapeCount() const {
+        return boxes.size() + orientedBoxes.size() + triangles.size() + circles.size();
+    }
+
+    // Index of the section containing x (sections must be non-empty).
+    size_t sectionAt(float x) const {
+        auto it = std::upper_bound(sections.begin(), sections.end(), x,
+            [](float v, const Section& s) { return v < s.startX; });
+        return it == sections.begin() ? 0 : size_t(it - sections.begin()) - 1;
+    }
+};
+
+} // namespace amm
@@ -0,0 +1,184 @@
+// src/Lockstep.cpp
+// AutomaticMacroMaker - lockstep simulation of one input timeline at several tick rates
+// Developer: entity12208
+
+#include "Lockstep.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace amm {
+
+MultiRateConfig MultiRateConfig::single() {
+    MultiRateConfig c;
+    c.count = 1;
+    c.variants[0] = {1, 0};
+    return c;
+}
+
+MultiRateConfig MultiRateConfig::robust() {
+    MultiRateConfig c;
+    c.count = 4;
+    c.variants[0] = {1, 0};
+    c.variants[1] = {2, 0};
+    c.variants[2] = {4, 0};
+    c.variants[3] = {4, 1};
+    return c;
+}
+
+float LaneStates::minX() const {
+    float x = lane[0].x;
+    for (int i = 1; i < count; ++i) x = std::min(x, lane[i].x);
+    return x;
+}
+
+LaneStates spreadLanes(const PlayerState& s, const MultiRateConfig& config) {
+    LaneStates lanes;
+    lanes.count = config.count;
+    for (int i = 0; i < config.count; ++i) lanes.lane[i] = s;
+    return lanes;
+}
+
+uint64_t lanesKey(const LaneStates& lanes) {
+    uint64_t h = lanes.finishedMask;
+    for (int i = 0; i < lanes.count; ++i) h = (h ^ stateKey(lanes.lane[i])) * 0x100000001b3ull;
+    return h;
+}
+
+namespace {
+
+// Airborne lanes away from all geometry only integrate, which is done for the packed
+// lanes at once. Mirrors the integration part of stepPlayer.
+struct PackedLanes {
+    float x[4] = {}, y[4] = {}, vy[4] = {}, speed[4] = {}, dt[4] = {};
+    float dv[4] = {}, lo[4] = {}, hi[4] = {}, reset[4] = {}, resetTo[4] = {};
+};
+
+template <class L>
+void integrateLanes(PackedLanes& p) {
+    auto one = L::splat(1.0f);
+    auto m = L::load(p.reset);
+    auto dt = L::load(p.dt);
+    auto v = L::add(L::mul(L::load(p.vy), L::sub(one, m)), L::mul(L::load(p.resetTo), m));
+    v = L::max(L::load(p.lo), L::min(L::add(v, L::load(p.dv)), L::load(p.hi)));
+    L::store(p.vy, v);
+    L::store(p.y, L::add(L::load(p.y), L::mul(v, dt)));
+    L::store(p.x, L::add(L::load(p.x), L::mul(L::load(p.speed), dt)));
+}
+
+// Whether the input has no effect beyond integration this step (no jump, flip, orb...).
+bool inputOnlyIntegrates(const PlayerState& s, bool hold) {
+    if (s.onGround || s.lastInteract != 0) return false;
+    bool pressed = hold && !s.held;
+    switch (s.mode) {
+        case Gamemode::Ufo:
+        case Gamemode::Swing: return !pressed;
+        default: return true;
+    }
+}
+
+} // namespace
+
+StepOutcome stepLanes(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                      LaneStates& lanes, bool hold, float dt) {
+    thread_local ShapeList candidates;
+    const uint8_t allLanes = (uint8_t)((1u << lanes.count) - 1);
+
+    for (int j = 0; j < MAX_SUBSTEPS; ++j) {
+        int active[MAX_LANES];
+        bool laneHold[MAX_LANES];
+        float laneDt[MAX_LANES];
+        int n = 0;
+        for (int i = 0; i < lanes.count; ++i) {
+            if (lanes.finishedMask & (1u << i)) continue;
+            const RateVariant& v = config.variants[i];
+            int stride = MAX_SUBSTEPS / v.substeps;
+            if ((j + 1) % stride != 0) continue;
+            int substep = (j + 1) / stride - 1;
+            laneHold[i] = substep < v.inputDelay ? lanes.lane[i].held : hold;
+            laneDt[i] = dt / (float)v.substeps;
+            active[n++] = i;
+        }
+        if (n == 0) continue;
+
+        // Lanes that may touch something this step take the full stepPlayer path.
+        PackedLanes packed;
+        int fast[MAX_LANES];
+        int nFast = 0;
+        for (int k = 0; k < n; ++k) {
+            int i = active[k];
+            PlayerState& s = lanes.lane[i];
+            bool sectionChange = s.section + 1u < level.sections.size() && s.x >= level.sections[s.section + 1].startX;
+            bool fastPath = !sectionChange && inputOnlyIntegrates(s, laneHold[i]);
+            if (fastPath) {
+                const ModeParams& p = modeParams(s.mode);
+                const Section& sec = level.sections[s.section];
+                float h = p.halfSize;
+                float sweepY = (std::fabs(s.vy) + std::max(p.gravity, SHIP_THRUST) * laneDt[i] + s.speed) * laneDt[i];
+                Aabb swept = {s.x - h, s.y - h - sweepY, s.x + h + s.speed * laneDt[i], s.y + h + sweepY};
+                fastPath = swept.minY > sec.floorY && swept.maxY < sec.ceilY && swept.maxX < level.endX;
+                if (fastPath) {
+                    candidates.clear();
+                    broadphase.query(swept, candidates);
+                    const std::vector<uint32_t>* families[4] = {&candidates.boxes, &candidates.orientedBoxes,
+                                                                &candidates.triangles, &candidates.circles};
+                    for (int f = 0; f < 4 && fastPath; ++f) {
+                        for (uint32_t idx : *families[f]) {
+                            Aabb b = shapeBounds(level, (ShapeFamily)f, idx);
+                            if (b.minX < swept.maxX && swept.minX < b.maxX && b.minY < swept.maxY && swept.minY < b.maxY) {
+                                fastPath = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (!fastPath) {
+                auto outcome = stepPlayer(level, broadphase, s, laneHold[i], laneDt[i]);
+                if (outcome == StepOutcome::Dead) return StepOutcome::Dead;
+                if (outcome == StepOutcome::Finished) lanes.finishedMask |= (uint8_t)(1u << i);
+                continue;
+            }
+
+            const ModeParams& p = modeParams(s.mode);
+            float up = s.flipped ? -1.0f : 1.0f;
+            int l = nFast;
+            packed.x[l] = s.x;
+            packed.y[l] = s.y;
+            packed.vy[l] = s.vy;
+            packed.speed[l] = s.speed;
+            packed.dt[l] = laneDt[i];
+            packed.lo[l] = -p.maxFall;
+            packed.hi[l] = p.maxFall;
+            if (s.mode == Gamemode::Wave) {
+                packed.reset[l] = 1.0f;
+                packed.resetTo[l] = (laneHold[i] ? 1.0f : -1.0f) * up * s.speed;
+                packed.lo[l] = -1.0e9f;
+                packed.hi[l] = 1.0e9f;
+            } else if (s.mode == Gamemode::Ship) {
+                packed.dv[l] = (laneHold[i] ? SHIP_THRUST : -p.gravity) * up * laneDt[i];
+            } else {
+                packed.dv[l] = -(p.gravity * up * laneDt[i]);
+            }
+            fast[nFast++] = i;
+        }
+
+        if (nFast == 0) continue;
+        if (simd::activeBackend() == simd::Backend::Scalar) integrateLanes<simd::ScalarLanes>(packed);
+        else integrateLanes<simd::NativeLanes>(packed);
+        for (int l = 0; l < nFast; ++l) {
+            PlayerState& s = lanes.lane[fast[l]];
+            s.x = packed.x[l];
+            s.y = packed.y[l];
+            s.vy = packed.vy[l];
+            s.held = laneHold[fast[l]];
+            s.onGround = false;
+        }
+    }
+
+    return lanes.finishedMask == allLanes ? StepOutcome::Finished : StepOutcome::Alive;
+}
+
+} // namespace amm
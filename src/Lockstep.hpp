@@ -0,0 +1,57 @@
+// src/Lockstep.hpp
+// AutomaticMacroMaker - lockstep simulation of one input timeline at several tick rates
+// Developer: entity12208
+//
+// A timeline that survives at exactly 60 ticks per second can still die in the engine
+// when the game runs its physics at a different rate or the input lands a sub-tick
+// late. In robust mode every branch is simulated as up to four variants at once, one
+// per SIMD lane, and a branch only survives if every variant survives. Each variant
+// splits the 60 Hz input tick into its own number of substeps and may apply the input
+// a few substeps late.
+
+#pragma once
+
+#include "Physics.hpp"
+
+#include <cstdint>
+
+namespace amm {
+
+static constexpr int MAX_LANES = 4;
+static constexpr int MAX_SUBSTEPS = 4;
+
+struct RateVariant {
+    uint8_t substeps = 1;    // physics steps per input tick: 1, 2 or 4
+    uint8_t inputDelay = 0;  // substeps the input change is applied late
+};
+
+struct MultiRateConfig {
+    uint8_t count = 1;
+    RateVariant variants[MAX_LANES] = {};
+
+    // Only the 60 Hz variant: stepping a LaneStates is then equivalent to stepPlayer.
+    static MultiRateConfig single();
+    // 60, 120 and 240 Hz, plus 240 Hz with the input one substep late.
+    static MultiRateConfig robust();
+};
+
+struct LaneStates {
+    PlayerState lane[MAX_LANES];
+    uint8_t count = 1;
+    uint8_t finishedMask = 0; // lanes that reached the level end (no longer stepped)
+
+    // The slowest lane decides whether the group as a whole has passed an X.
+    float minX() const;
+};
+
+LaneStates spreadLanes(const PlayerState& s, const MultiRateConfig& config);
+
+// Hash over all lanes (see stateKey).
+uint64_t lanesKey(const LaneStates& lanes);
+
+// Advances every lane by one input tick of length dt. Dead if any lane dies, Finished
+// once every lane has finished.
+StepOutcome stepLanes(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                      LaneStates& lanes, bool hold, float dt);
+
+} // namespace amm
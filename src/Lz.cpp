@@ -0,0 +1,93 @@
+// src/Lz.cpp
+// AutomaticMacroMaker - small LZ77 block codec for the packed corpus archive
+// Developer: entity12208
+
+#include "Lz.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace amm {
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr int HASH_BITS = 14;
+
+static uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void putLength(std::vector<uint8_t>& out, size_t extra) {
+    for (; extra >= 255; extra -= 255) out.push_back(255);
+    out.push_back((uint8_t)extra);
+}
+
+static void emit(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset,
+                 size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+    out.push_back((uint8_t)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15) putLength(out, literalCount - 15);
+    out.insert(out.end(), literals, literals + literalCount);
+    if (!matchLength) return;
+    out.push_back((uint8_t)offset);
+    out.push_back((uint8_t)(offset >> 8));
+    if (matchCode >= 15) putLength(out, matchCode - 15);
+}
+
+void lzCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, UINT32_MAX);
+    size_t anchor = 0, i = 0;
+    while (i + MIN_MATCH <= size) {
+        uint32_t h = (read32(data + i) * 2654435761u) >> (32 - HASH_BITS);
+        uint32_t candidate = table[h];
+        table[h] = (uint32_t)i;
+        if (candidate == UINT32_MAX || i - candidate > MAX_OFFSET || read32(data + candidate) != read32(data + i)) {
+            ++i;
+            continue;
+        }
+        size_t length = MIN_MATCH;
+        while (i + length < size && data[candidate + length] == data[i + length]) ++length;
+        emit(out, data + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    emit(out, data + anchor, size - anchor, 0, 0);
+}
+
+bool lzDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t rawSize) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    size_t o = 0;
+    auto length = [&](size_t base, size_t& n) {
+        n = base;
+        if (base != 15) return true;
+        for (;;) {
+            if (p == end) return false;
+            uint8_t b = *p++;
+            n += b;
+            if (b != 255) return true;
+        }
+    };
+    while (p < end) {
+        uint8_t token = *p++;
+        size_t literals, match;
+        if (!length(token >> 4, literals) || (size_t)(end - p) < literals || rawSize - o < literals) return false;
+        std::memcpy(out + o, p, literals);
+        p += literals;
+        o += literals;
+        if (p == end) break; // last sequence
+        if (end - p < 2) return false;
+        size_t offset = p[0] | (size_t(p[1]) << 8);
+        p += 2;
+        if (!length(token & 15, match)) return false;
+        match += MIN_MATCH;
+        if (offset == 0 || offset > o || rawSize - o < match) return false;
+        // Byte by byte: matches may overlap their own output (runs).
+        for (size_t k = 0; k < match; ++k, ++o) out[o] = out[o - offset];
+    }
+    return o == rawSize;
+}
+
+} // namespace amm
@@ -0,0 +1,26 @@
+// src/Lz.hpp
+// AutomaticMacroMaker - small LZ77 block codec for the packed corpus archive
+// Developer: entity12208
+//
+// Snapshots are mostly runs of the same few values (shape kinds, grid-aligned
+// coordinates, one section record after another), which a plain LZ77 pass with a hash
+// of the last position per 4-byte prefix shrinks well without pulling in a compression
+// library. The block format follows LZ4's: a token with the literal and match lengths
+// in its two nibbles (15 meaning "more length bytes follow"), the literals, then a
+// 16-bit little-endian back offset. The last sequence carries literals only.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+// Appends the compressed block to `out`.
+void lzCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+// Decodes a block into exactly `rawSize` bytes at `out`. False on corrupt input.
+bool lzDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t rawSize);
+
+} // namespace amm
@@ -0,0 +1,45 @@
+// src/MainThreadProfiler.cpp
+// AutomaticMacroMaker - timing of the mod's work on the cocos thread
+// Developer: entity12208
+
+#include "MainThreadProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace amm {
+
+// Bucket bounds in ms: fine below a frame, coarse above it.
+static const std::vector<double> SITE_BUCKETS_MS = {0.05, 0.1, 0.25, 0.5, 1, 2, 4, 8, 16.7, 33.3, 66.7, 250, 1000, 5000};
+
+MainThreadProfiler::Site::Site(const char* siteName) : name(siteName), ms(SITE_BUCKETS_MS) {}
+
+MainThreadProfiler::Site& MainThreadProfiler::site(const char* name) {
+    for (auto& s : m_sites)
+        if (s.name == name) return s;
+    return m_sites.emplace_back(name);
+}
+
+void MainThreadProfiler::record(const char* name, double ms) {
+    Site& s = site(name);
+    s.ms.observe(ms);
+    s.maxMs = std::max(s.maxMs, ms);
+    if (ms <= m_hitchMs) return;
+    s.hitches++;
+    if (m_onHitch) m_onHitch(s.name, ms);
+}
+
+std::string MainThreadProfiler::summary() const {
+    std::string out;
+    for (const auto& s : m_sites) {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%s%s %llux p50/p99/max %.2f/%.2f/%.2f ms", out.empty() ? "" : "; ",
+            s.name.c_str(), (unsigned long long)s.ms.snapshot().count, std::min(s.ms.quantile(0.5), s.maxMs),
+            std::min(s.ms.quantile(0.99), s.maxMs), s.maxMs);
+        out += buf;
+        if (s.hitches > 0) out += ", " + std::to_string(s.hitches) + (s.hitches == 1 ? " hitch" : " hitches");
+    }
+    return out;
+}
+
+} // namespace amm
@@ -0,0 +1,75 @@
+// src/MainThreadProfiler.hpp
+// AutomaticMacroMaker - timing of the mod's work on the cocos thread
+// Developer: entity12208
+//
+// Whatever the mod runs on the main thread (button setup, the modal, snapshot
+// extraction, replay recording, status updates) delays the next frame. Each callback
+// site opens a Scope; the profiler keeps a duration histogram per site (Metrics.hpp)
+// and reports a hitch whenever one call takes longer than the threshold, by default
+// one 60 Hz frame. summary() is appended to the solve report.
+//
+// Engine-free so the mod glue only has to name the sites. Not thread-safe: every
+// site is on the main thread by definition.
+
+#pragma once
+
+#include "Metrics.hpp"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+
+namespace amm {
+
+class MainThreadProfiler {
+public:
+    static constexpr double DEFAULT_HITCH_MS = 1000.0 / 60.0;
+
+    using HitchHandler = std::function<void(const std::string& site, double ms)>;
+
+    class Scope {
+    public:
+        Scope(MainThreadProfiler& profiler, const char* site)
+            : m_profiler(profiler), m_site(site), m_start(std::chrono::steady_clock::now()) {}
+        ~Scope() {
+            m_profiler.record(m_site,
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count());
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        MainThreadProfiler& m_profiler;
+        const char* m_site;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    void setHitchThreshold(double ms) { m_hitchMs = ms; }
+    // Called for every hitch, right after the slow call returns.
+    void setHitchHandler(HitchHandler handler) { m_onHitch = std::move(handler); }
+
+    void record(const char* site, double ms);
+
+    // One entry per site: "<site> <calls>x p50/p99/max <a>/<b>/<c> ms[, <n> hitches]",
+    // joined with "; ". Empty before the first record.
+    std::string summary() const;
+
+private:
+    struct Site {
+        explicit Site(const char* siteName);
+
+        std::string name;
+        Histogram ms;
+        double maxMs = 0.0;
+        size_t hitches = 0;
+    };
+
+    Site& site(const char* name);
+
+    double m_hitchMs = DEFAULT_HITCH_MS;
+    HitchHandler m_onHitch;
+    std::deque<Site> m_sites;
+};
+
+} // namespace amm
@@ -0,0 +1,181 @@
+// src/Metrics.cpp
+// AutomaticMacroMaker - counters, gauges and histograms in Prometheus text format
+// Developer: entity12208
+
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace amm {
+
+namespace metrics_detail {
+size_t shardIndex() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+} // namespace metrics_detail
+
+static uint64_t toBits(double v) {
+    uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+static double fromBits(uint64_t b) {
+    double v;
+    std::memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& s : m_slots) total += s.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Gauge::add(double d) {
+    double cur = m_value.load(std::memory_order_relaxed);
+    while (!m_value.compare_exchange_weak(cur, cur + d, std::memory_order_relaxed)) {}
+}
+
+Histogram::Histogram(std::vector<double> bounds) : m_bounds(std::move(bounds)) {
+    for (auto& shard : m_shards) shard.buckets = std::vector<std::atomic<uint64_t>>(m_bounds.size() + 1);
+}
+
+void Histogram::observe(double v) {
+    Shard& shard = m_shards[metrics_detail::shardIndex()];
+    size_t b = size_t(std::lower_bound(m_bounds.begin(), m_bounds.end(), v) - m_bounds.begin());
+    shard.buckets[b].fetch_add(1, std::memory_order_relaxed);
+    // Only threads sharing this shard race on the sum, so the CAS rarely retries.
+    uint64_t cur = shard.sumBits.load(std::memory_order_relaxed);
+    while (!shard.sumBits.compare_exchange_weak(cur, toBits(fromBits(cur) + v), std::memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot s;
+    s.buckets.assign(m_bounds.size() + 1, 0);
+    for (const auto& shard : m_shards) {
+        for (size_t i = 0; i < s.buckets.size(); ++i) s.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        s.sum += fromBits(shard.sumBits.load(std::memory_order_relaxed));
+    }
+    for (size_t i = 1; i < s.buckets.size(); ++i) s.buckets[i] += s.buckets[i - 1];
+    s.count = s.buckets.back();
+    return s;
+}
+
+double Histogram::quantile(double q) const {
+    Snapshot s = snapshot();
+    if (s.count == 0) return 0.0;
+    double rank = q * (double)s.count;
+    for (size_t i = 0; i < s.buckets.size(); ++i) {
+        if ((double)s.buckets[i] < rank) continue;
+        // The +Inf bucket has no upper bound: report the largest finite one.
+        if (i == m_bounds.size()) return m_bounds.empty() ? 0.0 : m_bounds.back();
+        double lo = i == 0 ? 0.0 : m_bounds[i - 1];
+        uint64_t below = i == 0 ? 0 : s.buckets[i - 1];
+        uint64_t in = s.buckets[i] - below;
+        return in == 0 ? m_bounds[i] : lo + (m_bounds[i] - lo) * (rank - (double)below) / (double)in;
+    }
+    return m_bounds.empty() ? 0.0 : m_bounds.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard lock(m_mutex);
+    Counter& c = m_counters.emplace_back();
+    Entry& e = m_entries.emplace_back();
+    e.name = name; e.help = help; e.labels = labels; e.counter = &c;
+    return c;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard lock(m_mutex);
+    Gauge& g = m_gauges.emplace_back();
+    Entry& e = m_entries.emplace_back();
+    e.name = name; e.help = help; e.labels = labels; e.gauge = &g;
+    return g;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, std::vector<double> bounds,
+                                      const std::string& labels) {
+    std::lock_guard lock(m_mutex);
+    Histogram& h = m_histograms.emplace_back(std::move(bounds));
+    Entry& e = m_entries.emplace_back();
+    e.name = name; e.help = help; e.labels = labels; e.histogram = &h;
+    return h;
+}
+
+namespace {
+
+constexpr std::pair<double, const char*> QUANTILES[] = {{0.5, "0.5"}, {0.9, "0.9"}, {0.99, "0.99"}};
+
+std::string number(double v) {
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.10g", v);
+    return buf;
+}
+
+// `labels` plus one more label, wrapped in braces (or nothing if both are empty).
+std::string braces(const std::string& labels, const std::string& extra = {}) {
+    if (labels.empty() && extra.empty()) return {};
+    if (labels.empty()) return "{" + extra + "}";
+    if (extra.empty()) return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+void header(std::string& out, const std::string& name, const std::string& help, const char* type) {
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+} // namespace
+
+std::string MetricsRegistry::exposition() const {
+    std::lock_guard lock(m_mutex);
+    std::string out;
+    // Group by name in first-registration order: a family's samples must be contiguous.
+    std::vector<bool> done(m_entries.size(), false);
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (done[i]) continue;
+        const Entry& first = m_entries[i];
+        header(out, first.name, first.help, first.counter ? "counter" : first.gauge ? "gauge" : "histogram");
+        std::vector<const Entry*> family;
+        for (size_t j = i; j < m_entries.size(); ++j) {
+            if (m_entries[j].name != first.name) continue;
+            done[j] = true;
+            family.push_back(&m_entries[j]);
+        }
+        for (const Entry* e : family) {
+            if (e->counter) {
+                out += e->name + braces(e->labels) + " " + std::to_string(e->counter->value()) + "\n";
+            } else if (e->gauge) {
+                out += e->name + braces(e->labels) + " " + number(e->gauge->value()) + "\n";
+            } else {
+                Histogram::Snapshot s = e->histogram->snapshot();
+                const auto& bounds = e->histogram->bounds();
+                for (size_t b = 0; b < s.buckets.size(); ++b) {
+                    std::string le = "le=\"" + (b < bounds.size() ? number(bounds[b]) : std::string("+Inf")) + "\"";
+                    out += e->name + "_bucket" + braces(e->labels, le) + " " + std::to_string(s.buckets[b]) + "\n";
+                }
+                out += e->name + "_sum" + braces(e->labels) + " " + number(s.sum) + "\n";
+                out += e->name + "_count" + braces(e->labels) + " " + std::to_string(s.count) + "\n";
+            }
+        }
+        if (!first.histogram) continue;
+        std::string qname = first.name + "_quantiles";
+        header(out, qname, first.help + " (estimated from the buckets)", "summary");
+        for (const Entry* e : family) {
+            for (const auto& [q, label] : QUANTILES)
+                out += qname + braces(e->labels, std::string("quantile=\"") + label + "\"") + " " +
+                    number(e->histogram->quantile(q)) + "\n";
+        }
+    }
+    return out;
+}
+
+} // namespace amm
@@ -0,0 +1,116 @@
+// src/Metrics.hpp
+// AutomaticMacroMaker - counters, gauges and histograms in Prometheus text format
+// Developer: entity12208
+//
+// For long headless batch runs (see cli/main.cpp): workers update metrics while they
+// solve, and a scrape renders them in the Prometheus text exposition format. Updates
+// never lock. Counters and histograms are sharded: every thread adds to its own
+// cache-line-sized slot and a scrape sums the slots, so workers hammering the same
+// counter do not contend. Gauges are a single atomic since they are set, not summed.
+//
+// Metrics are created up front (creation locks) and live as long as the registry;
+// the references handed out stay valid.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace amm {
+
+namespace metrics_detail {
+static constexpr size_t SHARDS = 16;
+// This thread's shard, assigned round-robin on first use.
+size_t shardIndex();
+
+struct alignas(64) Slot {
+    std::atomic<uint64_t> value{0};
+};
+} // namespace metrics_detail
+
+class Counter {
+public:
+    void add(uint64_t n = 1) {
+        m_slots[metrics_detail::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+
+private:
+    std::array<metrics_detail::Slot, metrics_detail::SHARDS> m_slots;
+};
+
+class Gauge {
+public:
+    void set(double v) { m_value.store(v, std::memory_order_relaxed); }
+    void add(double d);
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+class Histogram {
+public:
+    // `bounds` are the bucket upper bounds, ascending; an implicit +Inf bucket follows.
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double v);
+
+    struct Snapshot {
+        std::vector<uint64_t> buckets; // cumulative, one per bound plus +Inf
+        uint64_t count = 0;
+        double sum = 0.0;
+    };
+    Snapshot snapshot() const;
+
+    // Linear interpolation inside the bucket that holds quantile q (0..1); 0 if empty.
+    double quantile(double q) const;
+
+    const std::vector<double>& bounds() const { return m_bounds; }
+
+private:
+    struct alignas(64) Shard {
+        std::vector<std::atomic<uint64_t>> buckets;
+        std::atomic<uint64_t> sumBits{0}; // double, updated by CAS
+    };
+
+    std::vector<double> m_bounds;
+    std::array<Shard, metrics_detail::SHARDS> m_shards;
+};
+
+class MetricsRegistry {
+public:
+    // `labels` is the inside of the braces, e.g. worker="3"; empty for none. Metrics
+    // with the same name share one HELP/TYPE header and differ by labels.
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help, std::vector<double> bounds,
+                         const std::string& labels = {});
+
+    // Every metric in the Prometheus text exposition format (version 0.0.4). Histograms
+    // also get a <name>_quantiles summary with the 0.5, 0.9 and 0.99 estimates.
+    std::string exposition() const;
+
+private:
+    // Exactly one of the pointers is set.
+    struct Entry {
+        std::string name, help, labels;
+        const Counter* counter = nullptr;
+        const Gauge* gauge = nullptr;
+        const Histogram* histogram = nullptr;
+    };
+
+    mutable std::mutex m_mutex;
+    std::deque<Counter> m_counters;
+    std::deque<Gauge> m_gauges;
+    std::deque<Histogram> m_histograms;
+    std::vector<Entry> m_entries;
+};
+
+} // namespace amm
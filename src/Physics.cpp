@@ -0,0 +1,319 @@
+// src/Physics.cpp
+// AutomaticMacroMaker - engine-free player physics clone used by the solver
+// Developer: entity12208
+
+#include "Physics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+namespace amm {
+
+// Tuned against 2.2 at 60 ticks per second.
+static constexpr ModeParams MODE_PARAMS[] = {
+    /* Cube   */ {2794.0f, 603.7f, 810.0f, 15.0f},
+    /* Ship   */ {1117.0f, 0.0f, 432.0f, 12.0f},
+    /* Ball   */ {1676.0f, 0.0f, 810.0f, 15.0f},
+    /* Ufo    */ {1676.0f, 430.0f, 690.0f, 15.0f},
+    /* Wave   */ {0.0f, 0.0f, 0.0f, 5.0f},
+    /* Robot  */ {2794.0f, 540.0f, 810.0f, 15.0f},
+    /* Spider */ {2794.0f, 0.0f, 810.0f, 15.0f},
+    /* Swing  */ {1676.0f, 0.0f, 432.0f, 15.0f},
+};
+
+static constexpr float SNAP_DISTANCE = 9.0f; // how far a surface may be crossed and still count as landing
+
+const ModeParams& modeParams(Gamemode m) { return MODE_PARAMS[(size_t)m]; }
+
+static float padVelocity(HitKind k) {
+    switch (k) {
+        case HitKind::YellowPad: return 864.0f;
+        case HitKind::PinkPad: return 562.0f;
+        case HitKind::RedPad: return 1080.0f;
+        case HitKind::YellowOrb: return 660.0f;
+        case HitKind::PinkOrb: return 480.0f;
+        case HitKind::RedOrb: return 900.0f;
+        case HitKind::GreenOrb: return 660.0f;
+        case HitKind::BlackOrb: return -1000.0f;
+        default: return 0.0f;
+    }
+}
+
+static bool slidesOnCeilings(Gamemode m) {
+    return m == Gamemode::Ship || m == Gamemode::Ufo || m == Gamemode::Wave || m == Gamemode::Swing;
+}
+
+static void enterSection(const LevelSnapshot& level, PlayerState& s, size_t index) {
+    const Section& sec = level.sections[index];
+    s.section = (uint16_t)index;
+    s.mode = sec.mode;
+    s.speed = sec.speed;
+    if (sec.setGravity >= 0) s.flipped = sec.setGravity == 1;
+}
+
+PlayerState initialState(const LevelSnapshot& level) {
+    PlayerState s;
+    s.x = level.startX;
+    s.y = level.startY;
+    s.vy = level.startVy;
+    s.flipped = level.startFlipped;
+    if (!level.sections.empty()) {
+        enterSection(level, s, level.sectionAt(level.startX));
+        s.flipped = level.startFlipped;
+    }
+    return s;
+}
+
+Aabb playerBox(const PlayerState& s) {
+    float h = modeParams(s.mode).halfSize;
+    return {s.x - h, s.y - h, s.x + h, s.y + h};
+}
+
+static inline uint64_t mix64(uint64_t h, uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    return h ^ (h >> 29);
+}
+
+uint64_t stateKey(const PlayerState& s) {
+    uint64_t h = 0;
+    h = mix64(h, (uint64_t)(int64_t)std::lround(s.x * 100.0f));
+    h = mix64(h, (uint64_t)(int64_t)std::lround(s.y * 100.0f));
+    h = mix64(h, (uint64_t)(int64_t)std::lround(s.vy * 10.0f));
+    h = mix64(h, ((uint64_t)s.section << 16) | ((uint64_t)s.mode << 8) |
+                 ((uint64_t)s.flipped << 2) | ((uint64_t)s.onGround << 1) | (uint64_t)s.held);
+    return mix64(h, s.lastInteract);
+}
+
+// Vertical extent of a triangle at x (x clamped into the triangle's X range).
+static void triangleSpanAt(const TriangleSet& t, uint32_t i, float x, float& lo, float& hi) {
+    const float xs[3] = {t.ax[i], t.bx[i], t.cx[i]};
+    const float ys[3] = {t.ay[i], t.by[i], t.cy[i]};
+    x = std::clamp(x, std::min({xs[0], xs[1], xs[2]}), std::max({xs[0], xs[1], xs[2]}));
+    lo = 1.0e9f;
+    hi = -1.0e9f;
+    for (int e = 0; e < 3; ++e) {
+        float x0 = xs[e], y0 = ys[e], x1 = xs[(e + 1) % 3], y1 = ys[(e + 1) % 3];
+        if (x < std::min(x0, x1) || x > std::max(x0, x1)) continue;
+        if (x1 == x0) {
+            lo = std::min(lo, std::min(y0, y1));
+            hi = std::max(hi, std::max(y0, y1));
+            continue;
+        }
+        float y = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
+        lo = std::min(lo, y);
+        hi = std::max(hi, y);
+    }
+}
+
+namespace {
+struct Surface {
+    float lo, hi;
+};
+}
+
+// Resolves contact with one solid. Returns false if the contact kills the player.
+static bool resolveSolid(PlayerState& s, const Surface& solid, float prevY, float half) {
+    float up = s.flipped ? -1.0f : 1.0f;
+    float standOn = up > 0 ? solid.hi : solid.lo;   // face we can land on
+    float bumpInto = up > 0 ? solid.lo : solid.hi;  // face above our head
+
+    float prevFeet = prevY - up * half;
+    if (s.vy * up <= 0.0f && (prevFeet - standOn) * up >= -SNAP_DISTANCE) {
+        s.y = standOn + up * half;
+        s.vy = 0.0f;
+        s.onGround = true;
+        return true;
+    }
+
+    float prevHead = prevY + up * half;
+    if (slidesOnCeilings(s.mode) && s.vy * up >= 0.0f && (bumpInto - prevHead) * up >= -SNAP_DISTANCE) {
+        s.y = bumpInto - up * half;
+        s.vy = 0.0f;
+        return true;
+    }
+    return false;
+}
+
+// Y of the nearest solid face in the "up" direction, used for spider teleports.
+static float oppositeSurface(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& s,
+                             ShapeList& candidates, ShapeList& contacts) {
+    const Section& sec = level.sections[s.section];
+    float half = modeParams(s.mode).halfSize;
+    bool up = !s.flipped;
+    float limit = up ? sec.ceilY : sec.floorY;
+
+    Aabb ray = up ? Aabb{s.x - half, s.y, s.x + half, std::min(limit, s.y + 2000.0f)}
+                  : Aabb{s.x - half, std::max(limit, s.y - 2000.0f), s.x + half, s.y};
+    findContacts(level, broadphase, ray, candidates, contacts);
+
+    float best = up ? ray.maxY : ray.minY;
+    for (uint32_t i : contacts.boxes) {
+        if (level.boxes.kind[i] != HitKind::Solid) continue;
+        best = up ? std::min(best, level.boxes.minY[i]) : std::max(best, level.boxes.maxY[i]);
+    }
+    return best;
+}
+
+bool nearUnusedOrb(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& s, float dt) {
+    thread_local ShapeList candidates, contacts;
+    Aabb box = playerBox(s);
+    float dy = std::fabs(s.vy) * dt + modeParams(s.mode).gravity * dt * dt;
+    box.maxX += s.speed * dt;
+    box.minY -= dy;
+    box.maxY += dy;
+    findContacts(level, broadphase, box, candidates, contacts);
+    for (uint32_t i : contacts.boxes)
+        if (isOrb(level.boxes.kind[i]) && i + 1 != s.lastInteract) return true;
+    return false;
+}
+
+float maxTickDeltaY(float speed, float dt) {
+    float fastest = speed; // the wave moves at 45 degrees
+    for (const ModeParams& p : MODE_PARAMS) fastest = std::max(fastest, p.maxFall);
+    return 2.0f * fastest * dt + SNAP_DISTANCE;
+}
+
+StepOutcome stepPlayer(const LevelSnapshot& level, const Broadphase& broadphase,
+                       PlayerState& s, bool hold, float dt) {
+    thread_local ShapeList candidates, contacts;
+
+    while (s.section + 1u < level.sections.size() && s.x >= level.sections[s.section + 1].startX)
+        enterSection(level, s, s.section + 1);
+
+    const ModeParams& p = modeParams(s.mode);
+    const Section& sec = level.sections[s.section];
+    bool pressed = hold && !s.held;
+    s.held = hold;
+    float up = s.flipped ? -1.0f : 1.0f;
+
+    // Input
+    switch (s.mode) {
+        case Gamemode::Cube:
+        case Gamemode::Robot:
+            if (hold && s.onGround) s.vy = p.jumpVelocity * up;
+            break;
+        case Gamemode::Ball:
+            if (pressed && s.onGround) { s.flipped = !s.flipped; s.vy = 0.0f; }
+            break;
+        case Gamemode::Ufo:
+            if (pressed) s.vy = p.jumpVelocity * up;
+            break;
+        case Gamemode::Swing:
+            if (pressed) s.flipped = !s.flipped;
+            break;
+        case Gamemode::Spider:
+            if (pressed && s.onGround) {
+                float surface = oppositeSurface(level, broadphase, s, candidates, contacts);
+                s.flipped = !s.flipped;
+                s.y = surface + (s.flipped ? -p.halfSize : p.halfSize);
+                s.vy = 0.0f;
+            }
+            break;
+        default:
+            break;
+    }
+    up = s.flipped ? -1.0f : 1.0f;
+
+    // Integrate
+    if (s.mode == Gamemode::Wave) {
+        s.vy = (hold ? 1.0f : -1.0f) * up * s.speed;
+    } else if (s.mode == Gamemode::Ship) {
+        s.vy += (hold ? SHIP_THRUST : -p.gravity) * up * dt;
+        s.vy = std::clamp(s.vy, -p.maxFall, p.maxFall);
+    } else {
+        s.vy -= p.gravity * up * dt;
+        s.vy = std::clamp(s.vy, -p.maxFall, p.maxFall);
+    }
+
+    float prevY = s.y;
+    s.x += s.speed * dt;
+    s.y += s.vy * dt;
+    s.onGround = false;
+
+    // Floor / ceiling of the current section never kill, they only stop the player.
+    float half = p.halfSize;
+    if (s.y - half < sec.floorY) {
+        s.y = sec.floorY + half;
+        if (up > 0) s.onGround = true;
+        s.vy = 0.0f;
+    } else if (s.y + half > sec.ceilY) {
+        s.y = sec.ceilY - half;
+        if (up < 0) s.onGround = true;
+        s.vy = 0.0f;
+    }
+
+    findPlayerContacts(level, broadphase, playerBox(s), half, candidates, contacts);
+
+    // Hazards and round shapes first: any overlap is fatal.
+    for (uint32_t i : contacts.boxes)
+        if (level.boxes.kind[i] == HitKind::Hazard) return StepOutcome::Dead;
+    for (uint32_t i : contacts.orientedBoxes)
+        if (level.orientedBoxes.kind[i] == HitKind::Hazard) return StepOutcome::Dead;
+    for (uint32_t i : contacts.triangles)
+        if (level.triangles.kind[i] == HitKind::Hazard) return StepOutcome::Dead;
+    for (uint32_t i : contacts.circles)
+        if (level.circles.kind[i] == HitKind::Hazard || level.circles.kind[i] == HitKind::Solid) return StepOutcome::Dead;
+
+    // Pads fire on touch, orbs on a press while overlapping. Each object fires once
+    // per contact, tracked through lastInteract.
+    uint32_t touching = 0;
+    for (uint32_t i : contacts.boxes) {
+        HitKind k = level.boxes.kind[i];
+        if (!isPad(k) && !isOrb(k)) continue;
+        if (i + 1 == s.lastInteract) { touching = i + 1; continue; }
+        if (touching != 0 || (isOrb(k) && !pressed)) continue;
+        touching = i + 1;
+        if (k == HitKind::BluePad) {
+            s.flipped = !s.flipped;
+            s.vy = 0.0f;
+        } else if (isPad(k)) {
+            s.vy = padVelocity(k) * up;
+        } else if (k == HitKind::BlueOrb || k == HitKind::GreenOrb) {
+            s.flipped = !s.flipped;
+            s.vy = padVelocity(k) * (s.flipped ? -1.0f : 1.0f);
+        } else {
+            s.vy = padVelocity(k) * up;
+        }
+    }
+    s.lastInteract = touching;
+    up = s.flipped ? -1.0f : 1.0f;
+
+    // Solids: land on them, slide under them (flying modes), or die on the side. Boxes
+    // resolve once per distinct surface, from the one furthest below the player up, so
+    // neither the order contacts come in nor how a surface is split into boxes
+    // (BoxMerge.hpp) changes the outcome.
+    thread_local std::vector<Surface> surfaces;
+    surfaces.clear();
+    for (uint32_t i : contacts.boxes)
+        if (level.boxes.kind[i] == HitKind::Solid) surfaces.push_back({level.boxes.minY[i], level.boxes.maxY[i]});
+    if (surfaces.size() > 1) {
+        std::sort(surfaces.begin(), surfaces.end(), [up](const Surface& a, const Surface& b) {
+            return up > 0 ? std::tie(a.lo, a.hi) < std::tie(b.lo, b.hi) : std::tie(a.hi, a.lo) > std::tie(b.hi, b.lo);
+        });
+        surfaces.erase(std::unique(surfaces.begin(), surfaces.end(),
+            [](const Surface& a, const Surface& b) { return a.lo == b.lo && a.hi == b.hi; }), surfaces.end());
+    }
+    for (const Surface& solid : surfaces)
+        if (!resolveSolid(s, solid, prevY, half)) return StepOutcome::Dead;
+    for (uint32_t i : contacts.orientedBoxes) {
+        if (level.orientedBoxes.kind[i] != HitKind::Solid) continue;
+        const auto& o = level.orientedBoxes;
+        float ext = std::fabs(o.sinA[i]) * o.hx[i] + std::fabs(o.cosA[i]) * o.hy[i];
+        if (!resolveSolid(s, {o.cy[i] - ext, o.cy[i] + ext}, prevY, half)) return StepOutcome::Dead;
+    }
+    for (uint32_t i : contacts.triangles) {
+        if (level.triangles.kind[i] != HitKind::Solid) continue;
+        Surface span;
+        triangleSpanAt(level.triangles, i, s.x, span.lo, span.hi);
+        if (!resolveSolid(s, span, prevY, half)) return StepOutcome::Dead;
+    }
+
+    if (s.x >= level.endX) return StepOutcome::Finished;
+    return StepOutcome::Alive;
+}
+
+} // namespace amm
@@ -0,0 +1,70 @@
+// src/Physics.hpp
+// AutomaticMacroMaker - engine-free player physics clone used by the solver
+// Developer: entity12208
+//
+// This is a deterministic approximation of GD 2.2 player movement, good enough to rank
+// and prune candidate inputs on the background thread. The final say on a timeline is
+// always the in-engine replay in onSolverFinished.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "LevelSnapshot.hpp"
+
+#include <cstdint>
+
+namespace amm {
+
+struct PlayerState {
+    float x = 0.0f;
+    float y = 0.0f;
+    float vy = 0.0f;        // world units per second, positive = up
+    uint16_t section = 0;   // index into LevelSnapshot::sections
+    Gamemode mode = Gamemode::Cube;
+    float speed = 311.58f;
+    bool flipped = false;   // upside-down gravity
+    bool onGround = false;
+    bool held = false;      // input state of the previous tick (for press edges)
+    uint32_t lastInteract = 0; // 1 + index of the pad/orb box currently being touched, 0 if none
+};
+
+// Per-gamemode constants. World units (30 per block) and seconds; "up" is relative to
+// the current gravity direction.
+struct ModeParams {
+    float gravity;
+    float jumpVelocity;
+    float maxFall;
+    float halfSize;
+};
+
+static constexpr float SHIP_THRUST = 1397.0f;
+
+const ModeParams& modeParams(Gamemode mode);
+
+enum class StepOutcome : uint8_t { Alive, Dead, Finished };
+
+// Player state at the snapshot point.
+PlayerState initialState(const LevelSnapshot& level);
+
+// Player hitbox for the current mode.
+Aabb playerBox(const PlayerState& s);
+
+// Hash of the state quantized finely enough (1/100 unit, 1/10 unit/s) that states with
+// equal keys behave the same from here on. Used for duplicate detection by the searches.
+uint64_t stateKey(const PlayerState& s);
+
+// True if a press on the next tick of length dt could activate an orb: the player's box,
+// swept by one tick of movement, overlaps an orb it is not already touching.
+bool nearUnusedOrb(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& s, float dt);
+
+// Upper bound on how far the player's Y, where hazards are tested, moves from one tick
+// of length dt to the next inside a section of horizontal speed `speed`: two moves at
+// the fastest vertical speed any mode reaches plus a landing snap. Spider teleports are
+// not bounded.
+float maxTickDeltaY(float speed, float dt);
+
+// Advances the player by one tick of length dt with the button held (or not).
+StepOutcome stepPlayer(const LevelSnapshot& level, const Broadphase& broadphase,
+                       PlayerState& s, bool hold, float dt);
+
+} // namespace amm
@@ -0,0 +1,197 @@
+// src/Repair.cpp
+// AutomaticMacroMaker - large-neighbourhood repair of timelines that die late
+// Developer: entity12208
+
+#include "Repair.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+namespace amm {
+
+namespace {
+
+struct Placement {
+    int64_t start = 0;  // first tick of the window
+    int64_t end = 0;    // first tick of the fixed suffix
+    LaneStates lanes;   // at `start`
+};
+
+// Best a placement reached: death = -1 when it finishes, `window` its inputs.
+struct Candidate {
+    int64_t death = 0;
+    Timeline window;
+};
+
+class WindowSearch {
+public:
+    WindowSearch(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                 const Timeline& inputs, float dt, uint64_t maxNodes, const Deadline& deadline,
+                 const std::atomic<bool>& stop)
+        : m_level(level), m_broadphase(broadphase), m_config(config), m_inputs(inputs), m_dt(dt),
+          m_maxNodes(maxNodes), m_deadline(deadline), m_stop(stop) {}
+
+    uint64_t nodes() const { return m_nodes; }
+
+    // Depth-first over the window, trying the original input first at every tick so the
+    // smallest changes come first. Every window end replays the fixed suffix.
+    Candidate run(const Placement& p) {
+        Candidate best;
+        best.death = p.start; // anything reaching further is better
+        struct Node {
+            LaneStates lanes;
+            uint8_t next = 0; // branches tried
+        };
+        std::vector<Node> stack;
+        stack.reserve((size_t)(p.end - p.start) + 1);
+        stack.push_back({p.lanes, 0});
+        Timeline path;
+        std::unordered_set<uint64_t> visited;
+
+        for (uint64_t iteration = 0; !stack.empty(); ++iteration) {
+            if ((iteration & 255) == 0 && (m_deadline.expired() || m_stop.load(std::memory_order_relaxed))) break;
+            if (m_nodes >= m_maxNodes) break;
+            Node& top = stack.back();
+            if (top.next == 2) {
+                stack.pop_back();
+                if (!path.empty()) path.pop_back();
+                continue;
+            }
+            int64_t tick = p.start + (int64_t)path.size();
+            bool original = tick < (int64_t)m_inputs.size() && m_inputs[(size_t)tick] != 0;
+            bool hold = top.next++ == 0 ? original : !original;
+
+            LaneStates lanes = top.lanes;
+            StepOutcome outcome = stepLanes(m_level, m_broadphase, m_config, lanes, hold, m_dt);
+            m_nodes++;
+            if (outcome == StepOutcome::Dead) continue; // never past the old death tick
+            if (outcome == StepOutcome::Finished) {
+                offer(best, -1, path, hold);
+                break;
+            }
+            if (!visited.insert(lanesKey(lanes)).second) continue;
+            if (tick + 1 == p.end) {
+                int64_t death = replaySuffix(lanes, p.end);
+                if (death == -1 || death > best.death) offer(best, death, path, hold);
+                if (death == -1) break;
+                continue;
+            }
+            path.push_back(hold);
+            stack.push_back({lanes, 0});
+        }
+        return best;
+    }
+
+private:
+    static void offer(Candidate& best, int64_t death, const Timeline& path, bool hold) {
+        best.death = death;
+        best.window = path;
+        best.window.push_back(hold);
+    }
+
+    int64_t replaySuffix(LaneStates lanes, int64_t from) {
+        for (size_t i = (size_t)from; i < m_inputs.size(); ++i) {
+            StepOutcome outcome = stepLanes(m_level, m_broadphase, m_config, lanes, m_inputs[i] != 0, m_dt);
+            m_nodes++;
+            if (outcome == StepOutcome::Dead) return (int64_t)i;
+            if (outcome == StepOutcome::Finished) return -1;
+        }
+        return (int64_t)m_inputs.size();
+    }
+
+    const LevelSnapshot& m_level;
+    const Broadphase& m_broadphase;
+    const MultiRateConfig& m_config;
+    const Timeline& m_inputs;
+    float m_dt;
+    uint64_t m_maxNodes;
+    const Deadline& m_deadline;
+    const std::atomic<bool>& m_stop;
+    uint64_t m_nodes = 0;
+};
+
+} // namespace
+
+int64_t deathTick(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                  const Timeline& inputs, float dt) {
+    LaneStates lanes = spreadLanes(initialState(level), config);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        StepOutcome outcome = stepLanes(level, broadphase, config, lanes, inputs[i] != 0, dt);
+        if (outcome == StepOutcome::Dead) return (int64_t)i;
+        if (outcome == StepOutcome::Finished) return -1;
+    }
+    return (int64_t)inputs.size();
+}
+
+bool repairRound(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                 Timeline& inputs, int64_t& death, float dt, int window, unsigned slides, uint64_t maxNodes,
+                 const Deadline& deadline, RepairStats* stats) {
+    if (death < 0 || window <= 0) return false;
+
+    // Windows end just past the death tick, then slide back half a window at a time.
+    std::vector<Placement> placements;
+    int64_t last = std::min<int64_t>(death + 1, (int64_t)inputs.size());
+    for (unsigned j = 0; j < std::max(1u, slides); ++j) {
+        Placement p;
+        p.end = last - (int64_t)j * std::max(1, window / 2);
+        p.start = std::max<int64_t>(0, p.end - window);
+        if (p.end <= p.start || (!placements.empty() && placements.back().start == p.start)) break;
+        placements.push_back(p);
+    }
+    if (placements.empty()) return false;
+
+    // One replay of the fixed prefix gives the lanes at every window start.
+    LaneStates lanes = spreadLanes(initialState(level), config);
+    int64_t tick = 0;
+    for (size_t i = placements.size(); i-- > 0;) {
+        for (; tick < placements[i].start; ++tick)
+            stepLanes(level, broadphase, config, lanes, inputs[(size_t)tick] != 0, dt);
+        placements[i].lanes = lanes;
+    }
+
+    std::vector<Candidate> results(placements.size());
+    std::atomic<size_t> next{0};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> nodes{0};
+    auto worker = [&] {
+        WindowSearch search(level, broadphase, config, inputs, dt, maxNodes, deadline, stop);
+        for (size_t j; (j = next.fetch_add(1)) < placements.size();) {
+            results[j] = search.run(placements[j]);
+            if (results[j].death == -1) stop = true;
+        }
+        nodes += search.nodes();
+    };
+    unsigned threads = std::min<unsigned>((unsigned)placements.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    size_t best = placements.size();
+    for (size_t j = 0; j < results.size(); ++j) {
+        if (results[j].window.empty()) continue;
+        if (results[j].death == -1) { best = j; break; }
+        if (results[j].death > death && (best == placements.size() || results[j].death > results[best].death)) best = j;
+    }
+    if (stats) {
+        stats->nodes += nodes;
+        stats->rounds++;
+        stats->windows += placements.size();
+    }
+    if (best == placements.size()) return false;
+
+    const Placement& p = placements[best];
+    const Candidate& c = results[best];
+    Timeline repaired(inputs.begin(), inputs.begin() + p.start);
+    repaired.insert(repaired.end(), c.window.begin(), c.window.end());
+    if (c.death != -1 || (int64_t)c.window.size() == p.end - p.start)
+        repaired.insert(repaired.end(), inputs.begin() + p.end, inputs.end());
+    inputs = std::move(repaired);
+    death = c.death;
+    if (stats) stats->improvements++;
+    return true;
+}
+
+} // namespace amm
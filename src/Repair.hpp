@@ -0,0 +1,45 @@
+// src/Repair.hpp
+// AutomaticMacroMaker - large-neighbourhood repair of timelines that die late
+// Developer: entity12208
+//
+// A timeline that dies a few seconds before the end is mostly right: searching the
+// whole level again to fix it throws that away. repairRound() keeps every input but a
+// window of `window` ticks just before the death tick, searches that window again
+// (depth-first over hold / release, one visited set per window) and replays the fixed
+// rest of the timeline from each end state the window reaches. The first window that
+// finishes the level wins; otherwise the one that gets furthest replaces the timeline
+// when it dies later than before.
+//
+// Each round tries `slides` placements of the window, each half a window further back,
+// on worker threads of their own; a placement that finishes stops the others. Callers
+// grow the window between rounds that bring no improvement (see RepairStrategy.cpp).
+
+#pragma once
+
+#include "Lockstep.hpp"
+#include "Segment.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace amm {
+
+struct RepairStats {
+    uint64_t nodes = 0;        // physics ticks, window searches and suffix replays
+    size_t rounds = 0;
+    size_t improvements = 0;   // rounds that moved the death tick (or finished)
+    size_t windows = 0;        // window placements searched
+};
+
+// Tick at which replaying `inputs` from the level start kills a lane (running out of
+// inputs before the end counts as dying there), or -1 when every lane finishes.
+int64_t deathTick(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                  const Timeline& inputs, float dt);
+
+// One repair round around the death tick `death` of `inputs` (see above). On success
+// `inputs` and `death` are updated and true is returned.
+bool repairRound(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                 Timeline& inputs, int64_t& death, float dt, int window, unsigned slides, uint64_t maxNodes,
+                 const Deadline& deadline, RepairStats* stats = nullptr);
+
+} // namespace amm
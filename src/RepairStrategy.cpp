@@ -0,0 +1,152 @@
+// src/RepairStrategy.cpp
+// AutomaticMacroMaker - solve at 60 Hz, then repair where the other rates die
+// Developer: entity12208
+//
+// A search that gets most of the way through a level and then fails, and a single-rate
+// solution that dies at a handful of spots at the other rates, are both near misses:
+// most of their inputs are right. This strategy first runs the section strategy at
+// 60 Hz only, for at most half the time. If it finds no solution, its furthest partial
+// timeline (SolverStrategy::partial) is taken instead, so the strategy repairs in both
+// modes. The timeline is padded with released ticks, replayed (in lockstep in robust
+// mode) to find the death tick, and handed to repairRound() (Repair.hpp) until every
+// lane finishes: each round that brings no improvement doubles the window, from
+// START_WINDOW up to MAX_WINDOW ticks, and an improvement sets it back. A repaired
+// timeline that runs out of inputs is padded again.
+
+#include "Repair.hpp"
+#include "SolveCost.hpp"
+#include "Strategy.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace amm {
+
+namespace {
+
+class RepairStrategy final : public SolverStrategy {
+public:
+    static constexpr int START_WINDOW = 15;  // ticks
+    static constexpr int MAX_WINDOW = 480;
+    static constexpr unsigned SLIDES = 4;    // window placements per round
+    static constexpr uint64_t MAX_NODES = 2000000; // per placement
+    static constexpr float PAD_SECONDS = 1.0f;     // released ticks appended to the seed
+    static constexpr int SEED_SHARE_PERCENT = 50;   // of the time left, for the seed solve
+
+    void prepare(const SolveContext& context) override {
+        m_ctx = context;
+        m_config = context.settings.robust ? MultiRateConfig::robust() : MultiRateConfig::single();
+        // The player moves at the section speeds, so a timeline never needs to be much
+        // longer than the level takes to play.
+        m_maxTicks = (size_t)std::lround((costFeatures(*context.level).seconds + 2.0f * PAD_SECONDS) /
+            context.settings.dt);
+        SolveContext seedContext = context;
+        seedContext.settings.robust = false;
+        seedContext.settings.solutions = 1;
+        seedContext.settings.sectionCache = nullptr; // kept for the caller's settings, not these
+        // Leave time to repair what the seed gets to if it cannot finish.
+        auto now = std::chrono::steady_clock::now();
+        if (context.deadline.at != std::chrono::steady_clock::time_point::max() && context.deadline.at > now)
+            seedContext.deadline.at = now + (context.deadline.at - now) * SEED_SHARE_PERCENT / 100;
+        m_seed = makeSectionStrategy();
+        m_seed->prepare(seedContext);
+    }
+
+    bool step(uint64_t budget) override {
+        if (m_done) return false;
+        if (m_seed) {
+            if (m_seed->step(budget)) return true;
+            std::vector<Timeline> found = m_seed->extract();
+            m_seedReport = m_seed->report();
+            m_seedWork = m_seed->progress().work;
+            m_fromPartial = found.empty();
+            m_timeline = m_fromPartial ? m_seed->partial() : std::move(found.front());
+            m_seed.reset();
+            // Gives the repair ticks past the last input; slower lanes can also still be
+            // short of the end when the 60 Hz one finishes.
+            pad();
+            m_firstDeath = m_death;
+            return m_death >= 0 || finish();
+        }
+
+        if (m_ctx.deadline.expired()) return finish();
+        if (repairRound(*m_ctx.level, *m_ctx.broadphase, m_config, m_timeline, m_death, m_ctx.settings.dt, m_window,
+                SLIDES, MAX_NODES, m_ctx.deadline, &m_stats)) {
+            m_window = START_WINDOW;
+            if (m_death >= (int64_t)m_timeline.size()) pad();
+            return m_death >= 0 || finish();
+        }
+        if (m_window >= MAX_WINDOW) return finish();
+        m_window = std::min(MAX_WINDOW, m_window * 2);
+        return true;
+    }
+
+    SolveProgress progress() const override {
+        if (m_seed) return m_seed->progress();
+        SolveProgress p;
+        p.fraction = m_death < 0 ? (m_timeline.empty() ? 0.0f : 1.0f)
+                                 : (float)m_death / (float)std::max<size_t>(1, m_timeline.size());
+        p.work = m_seedWork + m_stats.nodes;
+        p.solutions = solved() ? 1 : 0;
+        p.memory = m_timeline.capacity();
+        return p;
+    }
+
+    std::vector<Timeline> extract() override {
+        if (!solved()) return {};
+        return {m_timeline};
+    }
+
+    std::string report() const override {
+        std::string text = "seed: " + m_seedReport;
+        if (m_firstDeath >= 0)
+            text += std::string(m_fromPartial ? "; repair of the partial timeline" : "; repair") + " from tick " +
+                std::to_string(m_firstDeath) + ": " + std::to_string(m_stats.rounds) +
+                " rounds, " + std::to_string(m_stats.improvements) + " improvements, " +
+                std::to_string(m_stats.windows) + " windows, " + std::to_string(m_stats.nodes) + " ticks" +
+                (m_death >= 0 ? ", still dies at tick " + std::to_string(m_death) : std::string());
+        return text;
+    }
+
+private:
+    bool solved() const { return !m_seed && !m_timeline.empty() && m_death < 0; }
+
+    // Appends released ticks, PAD_SECONDS at a time, until replaying the timeline dies
+    // or finishes rather than running out of inputs: a window can only be repaired
+    // against a real death.
+    void pad() {
+        size_t ticks = (size_t)std::lround(PAD_SECONDS / m_ctx.settings.dt);
+        do {
+            m_timeline.resize(m_timeline.size() + ticks, 0);
+            m_death = deathTick(*m_ctx.level, *m_ctx.broadphase, m_config, m_timeline, m_ctx.settings.dt);
+        } while (m_death >= (int64_t)m_timeline.size() && m_timeline.size() < m_maxTicks);
+    }
+
+    bool finish() {
+        m_done = true;
+        return false;
+    }
+
+    SolveContext m_ctx;
+    MultiRateConfig m_config;
+    std::unique_ptr<SolverStrategy> m_seed; // until the single-rate solve is done
+    std::string m_seedReport;
+    uint64_t m_seedWork = 0;
+    bool m_fromPartial = false; // the seed found no solution
+
+    Timeline m_timeline;
+    size_t m_maxTicks = 0; // padding stops here: the level's play time plus slack
+    int64_t m_death = -1, m_firstDeath = -1;
+    int m_window = START_WINDOW;
+    RepairStats m_stats;
+    bool m_done = false;
+};
+
+} // namespace
+
+std::unique_ptr<SolverStrategy> makeRepairStrategy() {
+    return std::make_unique<RepairStrategy>();
+}
+
+} // namespace amm
@@ -0,0 +1,261 @@
+// src/SectionStrategy.cpp
+// AutomaticMacroMaker - the default strategy: solve one section at a time, backtracking
+// Developer: entity12208
+//
+// Ground gamemodes go through the surface graph, flying ones through the dense grid DP,
+// with the per-tick search as the fallback when either comes back empty. A section can
+// offer several exits; if the following sections cannot be solved from one, the next
+// one is tried. In robust mode each exit must also survive at every rate of the
+// lockstep config, and the lockstep tick search takes over when none does.
+//
+// Once a full solution is found the search keeps going for a short while to collect
+// diverse fallbacks (see Diversity.hpp). Section results are cached by entry state, so
+// the sections shared between solutions are solved only once; with a SectionCache in
+// the settings, so are the sections shared with earlier solves of the same level. A trained value model
+// (ValueModel.hpp) orders the exits of each section and the branches of the tick search.
+//
+// The backtracking is an explicit stack of sections so step() can stop between any two.
+// The inputs to the furthest section entered are kept as the partial timeline.
+
+#include "Diversity.hpp"
+#include "FlightGrid.hpp"
+#include "Strategy.hpp"
+#include "SurfaceGraph.hpp"
+#include "TickSearch.hpp"
+#include "ValueModel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace amm {
+
+namespace {
+
+// Replays a section's inputs in lockstep at every rate of `config`. False if any lane
+// dies, or the candidate claims the level end and not every lane gets there.
+bool replayLockstep(const LevelSnapshot& level, const Broadphase& bp, const MultiRateConfig& config, float dt,
+                    SegmentResult& candidate, const LaneStates& entry) {
+    LaneStates lanes = entry;
+    StepOutcome outcome = StepOutcome::Alive;
+    for (uint8_t hold : candidate.inputs) {
+        outcome = stepLanes(level, bp, config, lanes, hold != 0, dt);
+        if (outcome == StepOutcome::Dead) return false;
+    }
+    if (candidate.finished && outcome != StepOutcome::Finished) return false;
+    candidate.exitLanes = lanes;
+    return true;
+}
+
+class SectionStrategy final : public SolverStrategy {
+public:
+    void prepare(const SolveContext& context) override {
+        m_ctx = context;
+        m_config = context.settings.robust ? MultiRateConfig::robust() : MultiRateConfig::single();
+        m_solutions = SolutionSet(context.settings.solutions, context.settings.diverseMinFraction);
+        m_tickOptions.guide = context.settings.guide;
+        m_tickOptions.bitState = context.settings.bitState;
+        m_tickOptions.estimator = context.settings.estimator;
+        m_startX = context.level->startX;
+        m_bestX = m_startX;
+        m_cache = context.settings.sectionCache ? context.settings.sectionCache : &m_ownCache;
+        if (m_cache->robust != context.settings.robust || m_cache->candidates != context.settings.maxSectionCandidates) {
+            *m_cache = {};
+            m_cache->robust = context.settings.robust;
+            m_cache->candidates = context.settings.maxSectionCandidates;
+        }
+    }
+
+    // A section solved as the deadline ran out may be missing exits; a cache that
+    // outlives this solve must not keep it.
+    ~SectionStrategy() override {
+        if (m_incomplete && m_cache != &m_ownCache) {
+            auto it = m_cache->entries.find(*m_incomplete);
+            if (it != m_cache->entries.end()) {
+                m_cache->bytes -= entryBytes(it->second);
+                m_cache->entries.erase(it);
+            }
+        }
+    }
+
+    bool step(uint64_t budget) override {
+        uint64_t target = m_work + budget;
+        if (!m_started) {
+            m_started = true;
+            PlayerState initial = initialState(*m_ctx.level);
+            pushSection(initial, spreadLanes(initial, m_config));
+        }
+
+        while (!m_frames.empty() && m_work < target) {
+            if (m_ctx.deadline.expired() || m_solutions.full()) {
+                m_frames.clear();
+                break;
+            }
+            Frame& f = m_frames.back();
+            m_timeline.resize(f.mark);
+            if (f.next == f.candidates->size()) {
+                m_frames.pop_back();
+                continue;
+            }
+            const SegmentResult& c = (*f.candidates)[f.next++];
+            m_timeline.insert(m_timeline.end(), c.inputs.begin(), c.inputs.end());
+            if (c.finished) {
+                if (m_solutions.empty())
+                    m_ctx.deadline.at = std::min(m_ctx.deadline.at,
+                        std::chrono::steady_clock::now() + std::chrono::milliseconds(m_ctx.settings.diverseExtraMs));
+                m_solutions.offer(m_timeline);
+                m_bestX = m_ctx.level->endX;
+                continue;
+            }
+            pushSection(c.exit, c.exitLanes);
+        }
+        return !m_frames.empty();
+    }
+
+    SolveProgress progress() const override {
+        SolveProgress p;
+        float span = m_ctx.level->endX - m_startX;
+        p.fraction = span > 0.0f ? std::clamp((m_bestX - m_startX) / span, 0.0f, 1.0f) : 1.0f;
+        p.work = m_work;
+        p.solutions = m_solutions.solutions().size();
+        p.cached = m_cache->entries.size();
+        p.memory = m_cache->bytes + m_timeline.capacity() + m_frames.capacity() * sizeof(Frame);
+        return p;
+    }
+
+    std::vector<Timeline> extract() override {
+        return m_solutions.solutions();
+    }
+
+    Timeline partial() const override { return m_partial; }
+
+    std::string report() const override {
+        return std::to_string(m_graphNodes) + " graph nodes, " +
+            std::to_string(m_gridStats.fastSteps + m_gridStats.slowSteps) + " grid cells (" +
+            std::to_string(m_gridStats.planeBytes >> 10) + " of " + std::to_string(m_gridStats.rawPlaneBytes >> 10) +
+            " KB back pointers), " +
+            std::to_string(m_tickStats.nodes) + " tick nodes, " + std::to_string(m_tickStats.duplicates) +
+            " duplicates, " + std::to_string(m_config.count) + " rate lanes, " + std::to_string(m_lockstepRejects) +
+            " exits rejected by lockstep, " + std::to_string(m_solutions.solutions().size()) + " solutions, " +
+            std::to_string(m_solutions.rejected()) + " too similar, " + std::to_string(m_cacheHits) +
+            " section cache hits" + omissions(m_ctx.settings, m_tickStats) +
+            probes(m_ctx.settings, m_tickStats);
+    }
+
+private:
+    static constexpr size_t CACHE_ENTRY_BYTES = 64; // hash node + key + vector header
+
+    struct Frame {
+        const std::vector<SegmentResult>* candidates; // owned by m_cache
+        size_t next = 0;
+        size_t mark = 0; // timeline length at the section entry
+    };
+
+    static size_t entryBytes(const std::vector<SegmentResult>& candidates) {
+        size_t bytes = CACHE_ENTRY_BYTES;
+        for (const auto& c : candidates) bytes += sizeof(SegmentResult) + c.inputs.capacity();
+        return bytes;
+    }
+
+    // Solves (or looks up) the section entered at `s` and pushes its exits.
+    void pushSection(const PlayerState& s, const LaneStates& lanes) {
+        const SolverSettings& cfg = m_ctx.settings;
+        if (s.x > m_bestX) m_partial = m_timeline;
+        m_bestX = std::max(m_bestX, s.x);
+        uint64_t key = cfg.robust ? lanesKey(lanes) : stateKey(s);
+        auto it = m_cache->entries.find(key);
+        if (it != m_cache->entries.end()) {
+            m_cacheHits++;
+        } else {
+            it = m_cache->entries.emplace(key, solveSection(s, lanes)).first;
+            if (m_ctx.deadline.expired()) m_incomplete = key;
+            m_cache->bytes += entryBytes(it->second);
+        }
+        m_frames.push_back({&it->second, 0, m_timeline.size()});
+    }
+
+    std::vector<SegmentResult> solveSection(const PlayerState& s, const LaneStates& lanes) {
+        const LevelSnapshot& level = *m_ctx.level;
+        const Broadphase& bp = *m_ctx.broadphase;
+        const SolverSettings& cfg = m_ctx.settings;
+        float goalX = sectionGoalX(level, s.x);
+
+        Gamemode mode = level.sections[level.sectionAt(s.x)].mode;
+        std::vector<SegmentResult> candidates;
+        if (SurfaceGraph::handles(mode)) {
+            SurfaceGraph graph;
+            graph.build(level, bp, s, goalX, cfg.dt, m_ctx.deadline);
+            m_graphNodes += graph.nodeCount();
+            m_work += graph.nodeCount();
+            candidates = graph.solve(cfg.maxSectionCandidates);
+        } else if (flightGridHandles(mode)) {
+            uint64_t before = m_gridStats.fastSteps + m_gridStats.slowSteps;
+            candidates = solveFlightGrid(level, bp, s, goalX, cfg.dt, cfg.maxTicks, m_ctx.deadline,
+                cfg.maxSectionCandidates, &m_gridStats);
+            m_work += m_gridStats.fastSteps + m_gridStats.slowSteps - before;
+        }
+        if (cfg.robust) {
+            size_t before = candidates.size();
+            std::erase_if(candidates, [&](SegmentResult& c) {
+                return !replayLockstep(level, bp, m_config, cfg.dt, c, lanes);
+            });
+            m_lockstepRejects += before - candidates.size();
+        }
+        if (cfg.guide && cfg.guide->active() && candidates.size() > 1) rank(candidates);
+        if (candidates.empty()) {
+            SegmentResult r;
+            uint64_t before = m_tickStats.nodes;
+            bool ok = cfg.robust
+                ? searchTicksLockstep(level, bp, m_config, lanes, goalX, cfg.dt, cfg.maxTicks, m_ctx.deadline, r,
+                      &m_tickStats, m_tickOptions)
+                : searchTicks(level, bp, s, goalX, cfg.dt, cfg.maxTicks, m_ctx.deadline, r, &m_tickStats, m_tickOptions);
+            m_work += m_tickStats.nodes - before;
+            if (ok) candidates.push_back(std::move(r));
+        }
+        return candidates;
+    }
+
+    // Orders exits by the value model, best first; ties keep the solver's order.
+    void rank(std::vector<SegmentResult>& candidates) const {
+        std::vector<float> scores(candidates.size());
+        for (size_t i = 0; i < candidates.size(); i += 4) {
+            const PlayerState* exits[4];
+            size_t n = std::min<size_t>(4, candidates.size() - i);
+            for (size_t k = 0; k < n; ++k) exits[k] = &candidates[i + k].exit;
+            m_ctx.settings.guide->score(exits, n, &scores[i]);
+        }
+        std::vector<size_t> order(candidates.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+        std::vector<SegmentResult> ranked;
+        ranked.reserve(candidates.size());
+        for (size_t i : order) ranked.push_back(std::move(candidates[i]));
+        candidates = std::move(ranked);
+    }
+
+    SolveContext m_ctx;
+    MultiRateConfig m_config;
+    TickSearchOptions m_tickOptions;
+    SolutionSet m_solutions{1, 0.0f};
+    SectionCache m_ownCache;
+    SectionCache* m_cache = &m_ownCache;
+    std::optional<uint64_t> m_incomplete;
+    std::vector<Frame> m_frames;
+    Timeline m_timeline;
+    Timeline m_partial; // to the furthest section entry
+    bool m_started = false;
+    float m_startX = 0.0f, m_bestX = 0.0f;
+    uint64_t m_work = 0;
+
+    TickSearchStats m_tickStats;
+    FlightGridStats m_gridStats;
+    size_t m_graphNodes = 0, m_lockstepRejects = 0, m_cacheHits = 0;
+};
+
+} // namespace
+
+std::unique_ptr<SolverStrategy> makeSectionStrategy() {
+    return std::make_unique<SectionStrategy>();
+}
+
+} // namespace amm
@@ -0,0 +1,48 @@
+// src/Segment.hpp
+// AutomaticMacroMaker - types shared by the per-section solvers
+// Developer: entity12208
+//
+// The level is solved one section (see LevelSnapshot::sections) at a time. A section
+// solver starts from the player state at the section entry and produces inputs that
+// carry the player past goalX, plus the state it leaves in so the next section can
+// continue from there.
+
+#pragma once
+
+#include "Lockstep.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace amm {
+
+// One entry per simulated tick, non-zero = button held during that tick.
+using Timeline = std::vector<uint8_t>;
+
+struct SegmentResult {
+    Timeline inputs;
+    PlayerState exit;
+    bool finished = false; // reached the end of the level, not just the end of the section
+    LaneStates exitLanes;  // robust mode only: the exit state at every rate
+};
+
+// Wall-clock budget plus an optional external cancel flag.
+struct Deadline {
+    std::chrono::steady_clock::time_point at = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;
+
+    bool expired() const {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return true;
+        return std::chrono::steady_clock::now() >= at;
+    }
+};
+
+// X at which the section containing `x` ends (the level end for the last one).
+inline float sectionGoalX(const LevelSnapshot& level, float x) {
+    size_t i = level.sectionAt(x);
+    return i + 1 < level.sections.size() ? level.sections[i + 1].startX : level.endX;
+}
+
+} // namespace amm
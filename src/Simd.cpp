@@ -0,0 +1,57 @@
+// src/Simd.cpp
+// AutomaticMacroMaker - runtime backend selection for the batched kernels
+// Developer: entity12208
+
+#include "Simd.hpp"
+
+#include <atomic>
+
+#if defined(AMM_SIMD_SSE2) && defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace amm::simd {
+
+static std::atomic<bool> s_forceScalar{false};
+
+static Backend detectBackend() {
+#if defined(AMM_SIMD_SSE2)
+    #if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) ? Backend::Sse2 : Backend::Scalar;
+    #elif defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") ? Backend::Sse2 : Backend::Scalar;
+    #else
+    return Backend::Sse2;
+    #endif
+#elif defined(AMM_SIMD_NEON)
+    return Backend::Neon;
+#else
+    return Backend::Scalar;
+#endif
+}
+
+Backend nativeBackend() {
+    static const Backend detected = detectBackend();
+    return detected;
+}
+
+Backend activeBackend() {
+    return s_forceScalar.load(std::memory_order_relaxed) ? Backend::Scalar : nativeBackend();
+}
+
+const char* backendName(Backend b) {
+    switch (b) {
+        case Backend::Sse2: return "sse2";
+        case Backend::Neon: return "neon";
+        default: return "scalar";
+    }
+}
+
+void forceScalar(bool force) {
+    s_forceScalar.store(force, std::memory_order_relaxed);
+}
+
+} // namespace amm::simd
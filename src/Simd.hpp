@@ -0,0 +1,116 @@
+// src/Simd.hpp
+// AutomaticMacroMaker - 4-wide float lanes for the batched solver kernels
+// Developer: entity12208
+//
+// Kernels are written once as templates over a "lanes" type and instantiated twice:
+// once for the native vector unit (SSE2 on x86, NEON on ARM) and once for a plain
+// scalar fallback. Which instantiation runs is decided at runtime by activeBackend(),
+// so a build for one architecture still works on CPUs missing the vector unit and the
+// scalar path can be forced for debugging / determinism comparisons.
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define AMM_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define AMM_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace amm::simd {
+
+enum class Backend : uint8_t { Scalar, Sse2, Neon };
+
+// Best backend this CPU supports (detected once, then cached).
+Backend nativeBackend();
+
+// Backend the kernels should use right now: nativeBackend() unless forced to scalar.
+Backend activeBackend();
+const char* backendName(Backend b);
+
+// Forces the scalar lanes regardless of CPU support. Takes effect for kernels
+// selected after the call.
+void forceScalar(bool force);
+
+// Plain C++ lanes. Masks are all-ones / all-zeros per lane like the hardware versions.
+struct ScalarLanes {
+    struct F { float v[4]; };
+    struct M { uint32_t v[4]; };
+
+    static F load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static void store(float* p, F a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+    static F splat(float x) { return {{x, x, x, x}}; }
+
+#define AMM_SCALAR_BINOP(name, expr) \
+    static F name(F a, F b) { F r; for (int i = 0; i < 4; ++i) { float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+    AMM_SCALAR_BINOP(add, x + y)
+    AMM_SCALAR_BINOP(sub, x - y)
+    AMM_SCALAR_BINOP(mul, x * y)
+    AMM_SCALAR_BINOP(min, y < x ? y : x)
+    AMM_SCALAR_BINOP(max, y > x ? y : x)
+#undef AMM_SCALAR_BINOP
+
+    static F abs(F a) { F r; for (int i = 0; i < 4; ++i) r.v[i] = std::fabs(a.v[i]); return r; }
+    static M le(F a, F b) { M r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] <= b.v[i] ? ~0u : 0u; return r; }
+    static M lt(F a, F b) { M r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] < b.v[i] ? ~0u : 0u; return r; }
+    static M band(M a, M b) { M r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] & b.v[i]; return r; }
+    static M bor(M a, M b) { M r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] | b.v[i]; return r; }
+    static int bits(M m) {
+        return (m.v[0] & 1) | ((m.v[1] & 1) << 1) | ((m.v[2] & 1) << 2) | ((m.v[3] & 1) << 3);
+    }
+};
+
+#if defined(AMM_SIMD_SSE2)
+struct NativeLanes {
+    using F = __m128;
+    using M = __m128;
+
+    static F load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, F a) { _mm_storeu_ps(p, a); }
+    static F splat(float x) { return _mm_set1_ps(x); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F min(F a, F b) { return _mm_min_ps(a, b); }
+    static F max(F a, F b) { return _mm_max_ps(a, b); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static M le(F a, F b) { return _mm_cmple_ps(a, b); }
+    static M lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static M band(M a, M b) { return _mm_and_ps(a, b); }
+    static M bor(M a, M b) { return _mm_or_ps(a, b); }
+    static int bits(M m) { return _mm_movemask_ps(m); }
+};
+#elif defined(AMM_SIMD_NEON)
+struct NativeLanes {
+    using F = float32x4_t;
+    using M = uint32x4_t;
+
+    static F load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, F a) { vst1q_f32(p, a); }
+    static F splat(float x) { return vdupq_n_f32(x); }
+    static F add(F a, F b) { return vaddq_f32(a, b); }
+    static F sub(F a, F b) { return vsubq_f32(a, b); }
+    static F mul(F a, F b) { return vmulq_f32(a, b); }
+    static F min(F a, F b) { return vminq_f32(a, b); }
+    static F max(F a, F b) { return vmaxq_f32(a, b); }
+    static F abs(F a) { return vabsq_f32(a); }
+    static M le(F a, F b) { return vcleq_f32(a, b); }
+    static M lt(F a, F b) { return vcltq_f32(a, b); }
+    static M band(M a, M b) { return vandq_u32(a, b); }
+    static M bor(M a, M b) { return vorrq_u32(a, b); }
+    static int bits(M m) {
+        // vaddvq_u32 is AArch64-only; Android32 builds still need this to work.
+        uint32_t lanes[4];
+        vst1q_u32(lanes, m);
+        return (lanes[0] & 1) | ((lanes[1] & 1) << 1) | ((lanes[2] & 1) << 2) | ((lanes[3] & 1) << 3);
+    }
+};
+#else
+using NativeLanes = ScalarLanes;
+#endif
+
+} // namespace amm::simd
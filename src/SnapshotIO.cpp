@@ -0,0 +1,118 @@
+// src/SnapshotIO.cpp
+// AutomaticMacroMaker - reading and writing snapshots for the offline corpus
+// Developer: entity12208
+
+#include "SnapshotIO.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace amm {
+
+static constexpr uint32_t CORPUS_MAGIC = 0x534d4d41; // "AMMS"
+static constexpr uint32_t CORPUS_VERSION = 1;
+static constexpr uint32_t MAX_ARRAY = 1u << 26;      // sanity limit for corrupt files
+
+namespace {
+
+struct Writer {
+    std::vector<uint8_t>& out;
+
+    void bytes(const void* p, size_t n) {
+        size_t at = out.size();
+        out.resize(at + n);
+        std::memcpy(out.data() + at, p, n);
+    }
+    template <class T> void value(const T& v) { bytes(&v, sizeof(T)); }
+    template <class T> bool array(const std::vector<T>& v) {
+        value((uint32_t)v.size());
+        if (!v.empty()) bytes(v.data(), v.size() * sizeof(T));
+        return true;
+    }
+};
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool bytes(void* dst, size_t n) {
+        if ((size_t)(end - p) < n) return false;
+        std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+    template <class T> bool value(T& v) { return bytes(&v, sizeof(T)); }
+    template <class T> bool array(std::vector<T>& v) {
+        uint32_t n = 0;
+        if (!value(n) || n > MAX_ARRAY) return false;
+        v.resize(n);
+        return n == 0 || bytes(v.data(), n * sizeof(T));
+    }
+};
+
+// Both directions list the fields in the same order through one template.
+template <class IO, class Level>
+bool shapes(IO& io, Level& l) {
+    bool ok = true;
+    ok = ok && io.array(l.boxes.minX) && io.array(l.boxes.minY) && io.array(l.boxes.maxX) && io.array(l.boxes.maxY)
+            && io.array(l.boxes.kind);
+    ok = ok && io.array(l.orientedBoxes.cx) && io.array(l.orientedBoxes.cy) && io.array(l.orientedBoxes.hx)
+            && io.array(l.orientedBoxes.hy) && io.array(l.orientedBoxes.cosA) && io.array(l.orientedBoxes.sinA)
+            && io.array(l.orientedBoxes.kind);
+    ok = ok && io.array(l.triangles.ax) && io.array(l.triangles.ay) && io.array(l.triangles.bx)
+            && io.array(l.triangles.by) && io.array(l.triangles.cx) && io.array(l.triangles.cy)
+            && io.array(l.triangles.kind);
+    ok = ok && io.array(l.circles.cx) && io.array(l.circles.cy) && io.array(l.circles.r) && io.array(l.circles.kind);
+    return ok;
+}
+
+} // namespace
+
+void encodeCorpusEntry(const CorpusEntry& entry, std::vector<uint8_t>& out) {
+    out.clear();
+    Writer w{out};
+    const LevelSnapshot& l = entry.level;
+
+    w.value(CORPUS_MAGIC);
+    w.value(CORPUS_VERSION);
+    w.value(l.startX); w.value(l.startY); w.value(l.startVy); w.value(l.endX);
+    w.value((uint8_t)l.startFlipped);
+    w.array(l.sections);
+    shapes(w, l);
+    w.value((uint8_t)entry.solved);
+    w.array(entry.solution);
+}
+
+bool decodeCorpusEntry(const uint8_t* data, size_t size, CorpusEntry& entry) {
+    Reader r{data, data + size};
+    LevelSnapshot& l = entry.level;
+
+    uint32_t magic = 0, version = 0;
+    uint8_t flipped = 0, solved = 0;
+    if (!r.value(magic) || magic != CORPUS_MAGIC || !r.value(version) || version != CORPUS_VERSION) return false;
+    if (!r.value(l.startX) || !r.value(l.startY) || !r.value(l.startVy) || !r.value(l.endX) || !r.value(flipped))
+        return false;
+    if (!r.array(l.sections) || l.sections.empty() || !shapes(r, l)) return false;
+    if (!r.value(solved) || !r.array(entry.solution)) return false;
+    l.startFlipped = flipped != 0;
+    entry.solved = solved != 0;
+    return true;
+}
+
+bool saveCorpusEntry(const CorpusEntry& entry, const std::filesystem::path& path) {
+    std::vector<uint8_t> bytes;
+    encodeCorpusEntry(entry, bytes);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+    return (bool)out;
+}
+
+bool loadCorpusEntry(const std::filesystem::path& path, CorpusEntry& entry) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return decodeCorpusEntry(bytes.data(), bytes.size(), entry);
+}
+
+} // namespace amm
@@ -0,0 +1,39 @@
+// src/SnapshotIO.hpp
+// AutomaticMacroMaker - reading and writing snapshots for the offline corpus
+// Developer: entity12208
+//
+// With the corpus-dump setting on, the mod writes every snapshot it solves (plus the
+// solution, if one was found) to its save directory. The headless CLI reads the same
+// files back to train the value model without the game running. The format is a raw
+// little-endian dump of the snapshot's arrays behind a magic and a version; files from
+// another version are rejected rather than converted. The same bytes are what a packed
+// archive (CorpusArchive.hpp) stores per entry, hence the in-memory variants.
+
+#pragma once
+
+#include "Segment.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace amm {
+
+static constexpr const char* CORPUS_EXTENSION = ".amms";
+
+struct CorpusEntry {
+    LevelSnapshot level;
+    Timeline solution; // empty if the solver failed
+    bool solved = false;
+};
+
+bool saveCorpusEntry(const CorpusEntry& entry, const std::filesystem::path& path);
+// Returns false (leaving `entry` unspecified) on I/O errors, bad magic or version.
+bool loadCorpusEntry(const std::filesystem::path& path, CorpusEntry& entry);
+
+// The file contents, in memory. decodeCorpusEntry fails like loadCorpusEntry, and on
+// truncated data.
+void encodeCorpusEntry(const CorpusEntry& entry, std::vector<uint8_t>& out);
+bool decodeCorpusEntry(const uint8_t* data, size_t size, CorpusEntry& entry);
+
+} // namespace amm
@@ -0,0 +1,119 @@
+// src/SolutionCache.cpp
+// AutomaticMacroMaker - solutions kept on disk across sessions, one file per level
+// Developer: entity12208
+
+#include "SolutionCache.hpp"
+#include "Physics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace amm {
+
+bool SolutionCache::open(const std::filesystem::path& dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (!std::filesystem::is_directory(dir, ec)) return false;
+    std::vector<std::filesystem::path> stale;
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec))
+        if (e.path().extension() == ".tmp") stale.push_back(e.path());
+    for (const auto& p : stale) std::filesystem::remove(p, ec);
+    m_dir = dir;
+    return true;
+}
+
+std::filesystem::path SolutionCache::file(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return m_dir / (std::string(name) + CORPUS_EXTENSION);
+}
+
+bool SolutionCache::load(uint64_t key, CorpusEntry& entry) const {
+    return isOpen() && loadCorpusEntry(file(key), entry);
+}
+
+bool SolutionCache::store(uint64_t key, const CorpusEntry& entry) const {
+    if (!isOpen()) return false;
+    // A press and the idle solver may store the same key at once.
+    static std::atomic<uint64_t> writes{0};
+    std::filesystem::path target = file(key), temporary = target;
+    temporary += "." + std::to_string(writes.fetch_add(1)) + ".tmp";
+    if (!saveCorpusEntry(entry, temporary)) return false;
+    std::error_code ec;
+    std::filesystem::rename(temporary, target, ec);
+    if (ec) std::filesystem::remove(temporary, ec);
+    return !ec;
+}
+
+bool SolutionCache::offer(uint64_t key, const CorpusEntry& entry) const {
+    std::lock_guard<std::mutex> lock(m_offerMutex);
+    CorpusEntry known;
+    if (load(key, known) && known.solved && (!entry.solved || known.level.startX <= entry.level.startX))
+        return true;
+    return store(key, entry);
+}
+
+bool SolutionCache::contains(uint64_t key) const {
+    std::error_code ec;
+    return isOpen() && std::filesystem::exists(file(key), ec);
+}
+
+std::vector<uint64_t> SolutionCache::unsolved(size_t max) const {
+    std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> found;
+    std::error_code ec;
+    if (!isOpen()) return {};
+    for (const auto& e : std::filesystem::directory_iterator(m_dir, ec)) {
+        if (!e.is_regular_file() || e.path().extension() != CORPUS_EXTENSION) continue;
+        uint64_t key = std::strtoull(e.path().stem().string().c_str(), nullptr, 16);
+        CorpusEntry entry;
+        if (loadCorpusEntry(e.path(), entry) && !entry.solved) found.push_back({e.last_write_time(ec), key});
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < found.size() && i < max; ++i) keys.push_back(found[i].second);
+    return keys;
+}
+
+Timeline resumeSolution(const CorpusEntry& cached, const LevelSnapshot& live, const Broadphase& broadphase,
+                        float dt) {
+    if (!cached.solved || cached.solution.empty() || live.sections.empty() || cached.level.sections.empty())
+        return {};
+
+    // X before every tick of the cached solution, on the snapshot it was found on.
+    Broadphase own;
+    own.build(cached.level);
+    PlayerState s = initialState(cached.level);
+    std::vector<float> xs{s.x};
+    for (uint8_t hold : cached.solution) {
+        if (stepPlayer(cached.level, own, s, hold != 0, dt) != StepOutcome::Alive) break;
+        xs.push_back(s.x);
+    }
+
+    // Try the ticks next to the live start, nearest first.
+    size_t next = std::lower_bound(xs.begin(), xs.end(), live.startX) - xs.begin();
+    std::vector<size_t> ticks;
+    if (next < xs.size()) ticks.push_back(next);
+    if (next > 0) ticks.push_back(next - 1);
+    if (ticks.size() == 2 && std::fabs(xs[ticks[1]] - live.startX) < std::fabs(xs[ticks[0]] - live.startX))
+        std::swap(ticks[0], ticks[1]);
+
+    for (size_t tick : ticks) {
+        PlayerState p = initialState(live);
+        for (size_t i = tick; i < cached.solution.size(); ++i) {
+            StepOutcome outcome = stepPlayer(live, broadphase, p, cached.solution[i] != 0, dt);
+            if (outcome == StepOutcome::Dead) break;
+            if (outcome == StepOutcome::Finished)
+                return Timeline(cached.solution.begin() + (ptrdiff_t)tick, cached.solution.begin() + (ptrdiff_t)i + 1);
+        }
+    }
+    return {};
+}
+
+} // namespace amm
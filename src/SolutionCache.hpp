@@ -0,0 +1,63 @@
+// src/SolutionCache.hpp
+// AutomaticMacroMaker - solutions kept on disk across sessions, one file per level
+// Developer: entity12208
+//
+// A level solved once (by a press, or in the background by the idle solver, see
+// IdleSolver.hpp) should not be solved again. The cache is a directory holding one
+// corpus entry (SnapshotIO.hpp) per level, named after the glue's level key: the
+// snapshot the solve started from and its solution, or no solution if it failed, so
+// failed levels are not retried on every visit.
+//
+// A cached solution is never trusted as is: resumeSolution() steps it on its own
+// snapshot up to the X of the new request and keeps it only if the rest of it finishes
+// the new snapshot. Each write goes to a temporary name of its own and is renamed into
+// place, so a reader never sees half a file and two writers of one key never share one;
+// open() removes temporaries a crash left behind. Safe to use from several threads.
+//
+// Both writers, a press and the idle solver, go through offer(), which keeps the entry
+// that covers the most of the level: a solved entry is only replaced by a solution
+// from an earlier start, never by a failure.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "SnapshotIO.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace amm {
+
+class SolutionCache {
+public:
+    // Creates the directory if needed.
+    bool open(const std::filesystem::path& dir);
+    bool isOpen() const { return !m_dir.empty(); }
+
+    bool load(uint64_t key, CorpusEntry& entry) const;
+    bool store(uint64_t key, const CorpusEntry& entry) const;
+    // Stores `entry` unless the cache already holds a solved entry from the same or an
+    // earlier start. False only if the write failed.
+    bool offer(uint64_t key, const CorpusEntry& entry) const;
+    bool contains(uint64_t key) const;
+
+    // Keys of the entries without a solution, most recently written first.
+    std::vector<uint64_t> unsolved(size_t max) const;
+
+private:
+    std::filesystem::path file(uint64_t key) const;
+
+    std::filesystem::path m_dir;
+    mutable std::mutex m_offerMutex; // makes offer()'s load and store one step
+};
+
+// Inputs from `cached` (a solved entry of the same level) that finish `live` from its
+// start, or empty: the cached solution is stepped on its own snapshot up to live.startX,
+// and what is left of it must finish `live` on the physics clone.
+Timeline resumeSolution(const CorpusEntry& cached, const LevelSnapshot& live, const Broadphase& broadphase,
+                        float dt);
+
+} // namespace amm
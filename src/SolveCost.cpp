@@ -0,0 +1,71 @@
+// src/SolveCost.cpp
+// AutomaticMacroMaker - cheap up-front estimate of how hard a snapshot is to solve
+// Developer: entity12208
+
+#include "SolveCost.hpp"
+
+#include <algorithm>
+
+namespace amm {
+
+// Rough per-second costs of the section solvers, read off corpus benchmarks: the
+// surface graph stays small, the flight grid touches every cell of the corridor.
+static constexpr double GROUND_WORK_PER_SECOND = 2.0e4;
+static constexpr double FLYING_WORK_PER_SECOND = 6.0e5;
+static constexpr double DENSITY_WEIGHT = 0.02;       // per shape on screen
+static constexpr double SWITCH_WORK = 5.0e4;         // a new section start, with its backtracking
+static constexpr double INTERACTIVE_WORK = 2.0e3;    // per orb / pad
+
+static constexpr size_t SHAPE_BYTES = 96;            // snapshot + broadphase per shape
+static constexpr size_t GROUND_BYTES_PER_SECOND = 2u << 20;
+static constexpr size_t FLYING_BYTES_PER_SECOND = 24u << 20;
+static constexpr size_t BASE_BYTES = 8u << 20;
+
+static bool flying(Gamemode mode) {
+    return mode == Gamemode::Ship || mode == Gamemode::Ufo || mode == Gamemode::Wave || mode == Gamemode::Swing;
+}
+
+static size_t countInteractive(const std::vector<HitKind>& kinds) {
+    return (size_t)std::count_if(kinds.begin(), kinds.end(), [](HitKind k) { return isPad(k) || isOrb(k); });
+}
+
+CostFeatures costFeatures(const LevelSnapshot& level) {
+    CostFeatures f;
+    f.shapes = level.shapeCount();
+    f.length = std::max(0.0f, level.endX - level.startX);
+    f.interactive = countInteractive(level.boxes.kind) + countInteractive(level.orientedBoxes.kind) +
+        countInteractive(level.triangles.kind) + countInteractive(level.circles.kind);
+
+    float flyingSeconds = 0.0f;
+    const Section* previous = nullptr; // last section counted, passed ones are not
+    for (size_t i = 0; i < level.sections.size(); ++i) {
+        const Section& s = level.sections[i];
+        float from = std::max(s.startX, level.startX);
+        float to = i + 1 < level.sections.size() ? level.sections[i + 1].startX : level.endX;
+        if (to <= from || s.speed <= 0.0f) continue;
+        float seconds = (to - from) / s.speed;
+        f.seconds += seconds;
+        if (flying(s.mode)) flyingSeconds += seconds;
+        if (previous && s.mode != previous->mode) f.modeSwitches++;
+        if (s.setGravity >= 0) f.gravitySwitches++;
+        previous = &s;
+    }
+    if (f.seconds > 0.0f) f.flyingShare = flyingSeconds / f.seconds;
+    if (f.length > 0.0f) f.density = (float)f.shapes * SCREEN_WIDTH / f.length;
+    return f;
+}
+
+CostEstimate estimateCost(const CostFeatures& f) {
+    double flyingSeconds = f.seconds * f.flyingShare;
+    double groundSeconds = f.seconds - flyingSeconds;
+
+    CostEstimate e;
+    e.work = (groundSeconds * GROUND_WORK_PER_SECOND + flyingSeconds * FLYING_WORK_PER_SECOND) *
+        (1.0 + DENSITY_WEIGHT * f.density) +
+        (double)(f.modeSwitches + f.gravitySwitches) * SWITCH_WORK + (double)f.interactive * INTERACTIVE_WORK;
+    e.memory = BASE_BYTES + f.shapes * SHAPE_BYTES + (size_t)(groundSeconds * GROUND_BYTES_PER_SECOND) +
+        (size_t)(flyingSeconds * FLYING_BYTES_PER_SECOND);
+    return e;
+}
+
+} // namespace amm
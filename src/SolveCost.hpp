@@ -0,0 +1,45 @@
+// src/SolveCost.hpp
+// AutomaticMacroMaker - cheap up-front estimate of how hard a snapshot is to solve
+// Developer: entity12208
+//
+// Used to order batch work (see BatchQueue.hpp), not to make solver decisions: it only
+// has to rank levels roughly right, so it reads a handful of snapshot features in one
+// pass and combines them with fixed weights. The time estimate is in solver work units
+// (physics steps / graph nodes / grid cells, as in Strategy.hpp), the memory estimate
+// in bytes for the snapshot, its broadphase and the search state.
+
+#pragma once
+
+#include "LevelSnapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace amm {
+
+struct CostFeatures {
+    float length = 0.0f;        // X units from the start to the level end
+    float seconds = 0.0f;       // play time at the section speeds
+    float density = 0.0f;       // shapes per screen width (SCREEN_WIDTH units)
+    float flyingShare = 0.0f;   // share of the play time in ship / ufo / wave / swing
+    size_t shapes = 0;
+    size_t modeSwitches = 0;    // section boundaries that change the gamemode
+    size_t gravitySwitches = 0; // sections that set the gravity on entry
+    size_t interactive = 0;     // orbs and pads: every one adds a branch to the search
+};
+
+struct CostEstimate {
+    double work = 0.0;   // predicted solver work units
+    size_t memory = 0;   // predicted peak bytes
+};
+
+static constexpr float SCREEN_WIDTH = 570.0f;
+
+CostFeatures costFeatures(const LevelSnapshot& level);
+CostEstimate estimateCost(const CostFeatures& features);
+
+inline CostEstimate estimateCost(const LevelSnapshot& level) {
+    return estimateCost(costFeatures(level));
+}
+
+} // namespace amm
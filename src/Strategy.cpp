@@ -0,0 +1,61 @@
+// src/Strategy.cpp
+// AutomaticMacroMaker - pluggable solver strategies and their registry
+// Developer: entity12208
+
+#include "Strategy.hpp"
+#include "TreeEstimate.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace amm {
+
+// Built-ins are listed here rather than self-registering from their own files: the
+// headless build links the core as a static library, which would drop them.
+static std::vector<StrategyInfo>& registry() {
+    static std::vector<StrategyInfo> list = {
+        {"sections", "surface graph / flight grid per section, tick search fallback, backtracking", makeSectionStrategy},
+        {"ticks", "per-tick depth-first search over the whole level", makeTickStrategy},
+        {"horizon", "receding horizon: tick search a few seconds ahead, commit the first second", makeHorizonStrategy},
+        {"repair", "solve at 60 Hz, then repair the windows before the death tick of the result or of the furthest partial timeline", makeRepairStrategy},
+    };
+    return list;
+}
+
+const std::vector<StrategyInfo>& strategies() {
+    return registry();
+}
+
+void registerStrategy(StrategyInfo info) {
+    for (auto& s : registry()) {
+        if (s.name == info.name) {
+            s = std::move(info);
+            return;
+        }
+    }
+    registry().push_back(std::move(info));
+}
+
+std::unique_ptr<SolverStrategy> createStrategy(const std::string& name) {
+    for (const auto& s : registry())
+        if (s.name == name) return s.create();
+    return nullptr;
+}
+
+std::string omissions(const SolverSettings& settings, const TickSearchStats& stats) {
+    if (!settings.bitState) return {};
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), ", ~%.2f states lost to bit-state collisions", stats.omissions);
+    return buf;
+}
+
+std::string probes(const SolverSettings& settings, const TickSearchStats& stats) {
+    if (!settings.estimator || settings.estimator->probes() == 0) return {};
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), ", %llu tree probes (%.2f%% of the search)",
+        (unsigned long long)settings.estimator->probes(),
+        100.0 * (double)settings.estimator->probeSteps() / (double)std::max<uint64_t>(stats.nodes, 1));
+    return buf;
+}
+
+} // namespace amm
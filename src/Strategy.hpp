@@ -0,0 +1,117 @@
+// src/Strategy.hpp
+// AutomaticMacroMaker - pluggable solver strategies and their registry
+// Developer: entity12208
+//
+// A strategy turns a snapshot into input timelines. The mod, the CLI and the benchmark
+// all drive one the same way:
+//
+//   auto s = createStrategy(name);
+//   s->prepare(context);
+//   while (s->step(budget)) { ... s->progress() ... }
+//   auto solutions = s->extract();
+//
+// step() does about `budget` units of work (physics steps, graph nodes or grid cells)
+// and returns false once the strategy is done: solved, exhausted or out of time. The
+// budget is soft; a strategy may finish the unit it is in (e.g. one section) first.
+// New strategies are added by implementing SolverStrategy and registering a factory;
+// nothing in the mod glue has to change.
+
+#pragma once
+
+#include "Segment.hpp"
+#include "TickSearch.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace amm {
+
+// Section results by entry state (SectionStrategy.cpp). A strategy normally keeps its
+// own; one passed in through the settings outlives the solve, so later solves on the
+// same shapes (LevelCache.hpp) start with every section already solved. Entry states
+// hold section and shape indices; rebase() keeps both as long as no shape moved, which
+// is when the glue shares the cache. Results depend on the settings below as well,
+// which is why they are recorded with it.
+struct SectionCache {
+    std::unordered_map<uint64_t, std::vector<SegmentResult>> entries;
+    size_t bytes = 0;
+    bool robust = false;
+    size_t candidates = 0;
+};
+
+struct SolverSettings {
+    float dt = 1.0f / 60.0f;
+    int maxTicks = 60 * 60 * 2;        // per tick search
+    size_t maxSectionCandidates = 4;   // exits tried per section before backtracking
+    bool robust = false;               // multi-rate lockstep validation (Lockstep.hpp)
+    size_t solutions = 1;              // diverse solutions wanted (Diversity.hpp)
+    int diverseExtraMs = 5 * 1000;     // extra search time for fallback solutions
+    float diverseMinFraction = 0.2f;   // share of presses a fallback must change
+    const ValueGuide* guide = nullptr; // optional search ordering (ValueModel.hpp)
+    BitStateSet* bitState = nullptr;   // optional lossy visited set (BitStateSet.hpp)
+    SectionCache* sectionCache = nullptr; // optional, kept across solves (see SectionCache)
+    TreeEstimator* estimator = nullptr;   // optional tick search tree estimate (TreeEstimate.hpp)
+};
+
+// Everything a strategy reads. The level and broadphase must outlive the strategy.
+struct SolveContext {
+    const LevelSnapshot* level = nullptr;
+    const Broadphase* broadphase = nullptr;
+    SolverSettings settings;
+    Deadline deadline;
+};
+
+struct SolveProgress {
+    float fraction = 0.0f;  // furthest X reached, as a share of the level left to solve
+    uint64_t work = 0;      // budget units spent so far
+    size_t solutions = 0;
+    size_t cached = 0;      // entries in the strategy's own transposition / section cache
+    size_t memory = 0;      // approximate bytes the strategy holds between steps
+};
+
+class SolverStrategy {
+public:
+    virtual ~SolverStrategy() = default;
+
+    virtual void prepare(const SolveContext& context) = 0;
+    virtual bool step(uint64_t budget) = 0;
+    virtual SolveProgress progress() const = 0;
+    // Solutions found so far, best first (empty if none).
+    virtual std::vector<Timeline> extract() = 0;
+    // One line of strategy-specific statistics for logs and benchmarks.
+    virtual std::string report() const = 0;
+    // Inputs up to the furthest point reached without finishing, for strategies that
+    // repair it (RepairStrategy.cpp); the player has no known way on from the tick after
+    // the last input. Empty if the strategy does not track one.
+    virtual Timeline partial() const { return {}; }
+};
+
+using StrategyFactory = std::unique_ptr<SolverStrategy> (*)();
+
+struct StrategyInfo {
+    std::string name;
+    std::string description;
+    StrategyFactory create;
+};
+
+// Registered strategies, built-ins first. The first one is the default.
+const std::vector<StrategyInfo>& strategies();
+void registerStrategy(StrategyInfo info);
+// nullptr if no strategy has that name.
+std::unique_ptr<SolverStrategy> createStrategy(const std::string& name);
+
+// ", ~N states lost to bit-state collisions" when a bit-state set is in use, else empty.
+std::string omissions(const SolverSettings& settings, const TickSearchStats& stats);
+// ", N tree probes (P% of the search)" when an estimator probed, else empty.
+std::string probes(const SolverSettings& settings, const TickSearchStats& stats);
+
+// Built-ins (see SectionStrategy.cpp, TickStrategy.cpp, HorizonStrategy.cpp, RepairStrategy.cpp).
+std::unique_ptr<SolverStrategy> makeSectionStrategy();
+std::unique_ptr<SolverStrategy> makeTickStrategy();
+std::unique_ptr<SolverStrategy> makeHorizonStrategy();
+std::unique_ptr<SolverStrategy> makeRepairStrategy();
+
+} // namespace amm
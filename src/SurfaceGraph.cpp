@@ -0,0 +1,189 @@
+// src/SurfaceGraph.cpp
+// AutomaticMacroMaker - surface graph for ground-based sections
+// Developer: entity12208
+
+#include "SurfaceGraph.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace amm {
+
+static constexpr int MAX_ROLL_TICKS = 60 * 20;  // longest surface interval followed
+static constexpr int MAX_AIR_TICKS = 60 * 10;   // longest flight followed
+static constexpr int ORB_BUDGET = 2;            // orb presses allowed within one flight
+static constexpr uint64_t EXIT_KEY_SALT = 0x5bd1e9955bd1e995ull;
+
+bool SurfaceGraph::handles(Gamemode mode) {
+    return mode == Gamemode::Cube || mode == Gamemode::Ball || mode == Gamemode::Spider || mode == Gamemode::Robot;
+}
+
+bool SurfaceGraph::isExit(const PlayerState& s, StepOutcome outcome) const {
+    return outcome == StepOutcome::Finished || s.x >= m_goalX;
+}
+
+uint32_t SurfaceGraph::internNode(const PlayerState& s, uint32_t tick, StepOutcome outcome) {
+    bool exit = isExit(s, outcome);
+    uint64_t key = stateKey(s) ^ (exit ? EXIT_KEY_SALT : 0);
+    auto [it, inserted] = m_index.try_emplace(key, (uint32_t)m_nodes.size());
+    if (!inserted) return it->second;
+
+    Node node;
+    node.state = s;
+    node.tick = tick;
+    node.rollEnd = tick;
+    node.exit = exit;
+    node.finished = outcome == StepOutcome::Finished;
+    m_nodes.push_back(node);
+    m_outEdges.emplace_back();
+    if (!exit) m_pending.push_back(it->second);
+    return it->second;
+}
+
+void SurfaceGraph::addEdge(uint32_t from, uint32_t to, const std::vector<uint32_t>& presses) {
+    m_outEdges[from].push_back((uint32_t)m_edges.size());
+    m_edges.push_back({from, to, presses});
+}
+
+void SurfaceGraph::branchPress(uint32_t from, PlayerState s, uint32_t tick, std::vector<uint32_t>& presses, int orbBudget) {
+    presses.push_back(tick);
+    auto outcome = stepPlayer(*m_level, *m_broadphase, s, true, m_dt);
+    if (outcome != StepOutcome::Dead) {
+        if (isExit(s, outcome) || s.onGround) {
+            // Exits, and spider teleports which land within the press tick.
+            addEdge(from, internNode(s, tick + 1, outcome), presses);
+        } else {
+            follow(from, s, tick + 1, presses, orbBudget);
+        }
+    }
+    presses.pop_back();
+}
+
+void SurfaceGraph::follow(uint32_t from, PlayerState s, uint32_t tick, std::vector<uint32_t>& presses, int orbBudget) {
+    for (int i = 0; i < MAX_AIR_TICKS; ++i) {
+        if (orbBudget > 0 && nearUnusedOrb(*m_level, *m_broadphase, s, m_dt))
+            branchPress(from, s, tick, presses, orbBudget - 1);
+
+        auto outcome = stepPlayer(*m_level, *m_broadphase, s, false, m_dt);
+        tick++;
+        if (outcome == StepOutcome::Dead) return;
+        if (isExit(s, outcome) || s.onGround) {
+            addEdge(from, internNode(s, tick, outcome), presses);
+            return;
+        }
+    }
+}
+
+void SurfaceGraph::expand(uint32_t id) {
+    PlayerState s = m_nodes[id].state;
+    uint32_t tick = m_nodes[id].tick;
+    bool airborne = !s.onGround;
+    std::vector<uint32_t> presses;
+
+    // Roll along the surface without input; every tick on the ground (or next to an orb)
+    // is a place where a press leaves the interval.
+    for (int i = 0; i < MAX_ROLL_TICKS; ++i) {
+        if (s.onGround || nearUnusedOrb(*m_level, *m_broadphase, s, m_dt))
+            branchPress(id, s, tick, presses, ORB_BUDGET);
+
+        auto outcome = stepPlayer(*m_level, *m_broadphase, s, false, m_dt);
+        tick++;
+        if (outcome == StepOutcome::Dead) break;
+        if (isExit(s, outcome)) {
+            addEdge(id, internNode(s, tick, outcome), presses);
+            break;
+        }
+        if (!s.onGround) {
+            airborne = true;
+            continue;
+        }
+        if (airborne) {
+            // Rolled off the edge and landed somewhere else.
+            addEdge(id, internNode(s, tick, outcome), presses);
+            break;
+        }
+        // Still rolling: if another landing already reached this exact state, the rest
+        // of this interval is that node's interval.
+        auto it = m_index.find(stateKey(s));
+        if (it != m_index.end() && it->second != id) {
+            addEdge(id, it->second, presses);
+            break;
+        }
+    }
+    m_nodes[id].rollEnd = tick;
+}
+
+bool SurfaceGraph::build(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& entry,
+                         float goalX, float dt, const Deadline& deadline, size_t maxNodes) {
+    m_level = &level;
+    m_broadphase = &broadphase;
+    m_goalX = goalX;
+    m_dt = dt;
+    m_nodes.clear();
+    m_edges.clear();
+    m_outEdges.clear();
+    m_index.clear();
+    m_pending.clear();
+
+    internNode(entry, 0, StepOutcome::Alive);
+
+    // Breadth-first by discovery order so a truncated graph still covers the start of
+    // the section evenly.
+    for (size_t head = 0; head < m_pending.size(); ++head) {
+        if (m_nodes.size() >= maxNodes) return false;
+        if ((head & 15) == 0 && deadline.expired()) return false;
+        expand(m_pending[head]);
+    }
+    return true;
+}
+
+std::vector<SegmentResult> SurfaceGraph::solve(size_t maxResults) const {
+    std::vector<SegmentResult> results;
+    if (m_nodes.empty()) return results;
+
+    // Dijkstra on press count.
+    constexpr uint64_t INF = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> dist(m_nodes.size(), INF);
+    std::vector<uint32_t> via(m_nodes.size(), UINT32_MAX);
+    using Item = std::pair<uint64_t, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    dist[0] = 0;
+    open.push({0, 0});
+    while (!open.empty()) {
+        auto [d, n] = open.top();
+        open.pop();
+        if (d != dist[n]) continue;
+        for (uint32_t e : m_outEdges[n]) {
+            const Edge& edge = m_edges[e];
+            uint64_t nd = d + edge.pressTicks.size();
+            if (nd < dist[edge.to]) {
+                dist[edge.to] = nd;
+                via[edge.to] = e;
+                open.push({nd, edge.to});
+            }
+        }
+    }
+
+    std::vector<uint32_t> exits;
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        if (m_nodes[i].exit && dist[i] != INF) exits.push_back(i);
+    std::sort(exits.begin(), exits.end(), [&](uint32_t a, uint32_t b) {
+        if (dist[a] != dist[b]) return dist[a] < dist[b];
+        return m_nodes[a].tick < m_nodes[b].tick;
+    });
+    if (exits.size() > maxResults) exits.resize(maxResults);
+
+    for (uint32_t target : exits) {
+        SegmentResult r;
+        r.inputs.assign(m_nodes[target].tick, 0);
+        r.exit = m_nodes[target].state;
+        r.finished = m_nodes[target].finished;
+        for (uint32_t n = target; via[n] != UINT32_MAX; n = m_edges[via[n]].from)
+            for (uint32_t t : m_edges[via[n]].pressTicks) r.inputs[t] = 1;
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+} // namespace amm
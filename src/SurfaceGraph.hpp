@@ -0,0 +1,74 @@
+// src/SurfaceGraph.hpp
+// AutomaticMacroMaker - surface graph for ground-based sections
+// Developer: entity12208
+//
+// In cube / ball / spider / robot sections the only decisions that matter are made
+// while standing on something (jump, flip, teleport) or while touching an orb. This
+// pre-pass turns such a section into a graph:
+//  - nodes are the entry state and every distinct landing; a landing node stands for
+//    the surface interval the player then rolls along (tick .. rollEnd),
+//  - edges are the press (or no press) that leaves one interval and lands on another,
+//    carrying the exact ticks at which the button is pressed.
+// Solving the section is then a shortest-path query instead of a per-tick search.
+
+#pragma once
+
+#include "Segment.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace amm {
+
+class SurfaceGraph {
+public:
+    struct Node {
+        PlayerState state;
+        uint32_t tick = 0;      // ticks since the section entry
+        uint32_t rollEnd = 0;   // last tick of the surface interval (set once expanded)
+        bool exit = false;      // passed goalX or finished the level
+        bool finished = false;
+    };
+
+    struct Edge {
+        uint32_t from = 0, to = 0;
+        std::vector<uint32_t> pressTicks; // ticks (since entry) the button is held for one tick
+    };
+
+    static bool handles(Gamemode mode);
+
+    // Builds every node reachable from `entry`. Returns false if the deadline or node
+    // limit stopped it early; the partial graph can still be solved.
+    bool build(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& entry,
+               float goalX, float dt, const Deadline& deadline, size_t maxNodes = 200000);
+
+    // Up to maxResults input sequences reaching distinct exit nodes, cheapest first
+    // (fewest presses, then earliest exit).
+    std::vector<SegmentResult> solve(size_t maxResults) const;
+
+    size_t nodeCount() const { return m_nodes.size(); }
+    size_t edgeCount() const { return m_edges.size(); }
+
+private:
+    uint32_t internNode(const PlayerState& s, uint32_t tick, StepOutcome outcome);
+    void addEdge(uint32_t from, uint32_t to, const std::vector<uint32_t>& presses);
+    void expand(uint32_t node);
+    // Simulates a press at `tick` from `s`, then follows the flight until it lands.
+    void branchPress(uint32_t from, PlayerState s, uint32_t tick, std::vector<uint32_t>& presses, int orbBudget);
+    void follow(uint32_t from, PlayerState s, uint32_t tick, std::vector<uint32_t>& presses, int orbBudget);
+    bool isExit(const PlayerState& s, StepOutcome outcome) const;
+
+    const LevelSnapshot* m_level = nullptr;
+    const Broadphase* m_broadphase = nullptr;
+    float m_goalX = 0.0f;
+    float m_dt = 0.0f;
+
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+    std::vector<std::vector<uint32_t>> m_outEdges;
+    std::unordered_map<uint64_t, uint32_t> m_index;
+    std::vector<uint32_t> m_pending;
+};
+
+} // namespace amm
@@ -0,0 +1,79 @@
+// src/TaskGraph.cpp
+// AutomaticMacroMaker - dependency-ordered preparation stages run in parallel
+// Developer: entity12208
+
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace amm {
+
+using Clock = std::chrono::steady_clock;
+
+TaskGraph::Task TaskGraph::add(std::string name, std::function<void()> fn, std::vector<Task> after) {
+    Task task = m_tasks.size();
+    Node& node = m_tasks.emplace_back();
+    node.name = std::move(name);
+    node.fn = std::move(fn);
+    node.waiting = after.size();
+    for (Task t : after) m_tasks[t].next.push_back(task);
+    return task;
+}
+
+void TaskGraph::run(unsigned threads) {
+    auto start = Clock::now();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_threads = std::min<unsigned>(threads, (unsigned)std::max<size_t>(m_tasks.size(), 1));
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Task> ready;
+    size_t left = m_tasks.size();
+    for (Task t = 0; t < m_tasks.size(); ++t)
+        if (m_tasks[t].waiting == 0) ready.push_back(t);
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return !ready.empty() || left == 0; });
+            if (left == 0) return;
+            Task t = ready.back();
+            ready.pop_back();
+            lock.unlock();
+            auto taskStart = Clock::now();
+            m_tasks[t].fn();
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - taskStart).count();
+            lock.lock();
+            m_tasks[t].ms = ms;
+            for (Task n : m_tasks[t].next)
+                if (--m_tasks[n].waiting == 0) ready.push_back(n);
+            left--;
+            wake.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < m_threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    m_wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string TaskGraph::report() const {
+    std::string out;
+    char buf[96];
+    for (const Node& n : m_tasks) {
+        std::snprintf(buf, sizeof(buf), "%s%s %.1f ms", out.empty() ? "" : ", ", n.name.c_str(), n.ms);
+        out += buf;
+    }
+    std::snprintf(buf, sizeof(buf), " in %.1f ms on %u thread%s", m_wallMs, m_threads, m_threads == 1 ? "" : "s");
+    return out + buf;
+}
+
+} // namespace amm
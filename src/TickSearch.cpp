@@ -0,0 +1,247 @@
+// src/TickSearch.cpp
+// AutomaticMacroMaker - per-tick depth-first search over hold / release
+// Developer: entity12208
+
+#include "TickSearch.hpp"
+#include "BitStateSet.hpp"
+#include "TreeEstimate.hpp"
+#include "ValueModel.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace amm {
+
+namespace {
+
+// Exact visited set: open addressing with linear probing in one flat array. A node-based
+// set of millions of states took seconds just to free after the deadline; this one is a
+// single allocation, kept per thread and reused by the next search.
+class VisitedSet {
+public:
+    static constexpr size_t MIN_SLOTS = 1 << 16;
+
+    // Forgets every state. A table much larger than the last search needed is dropped
+    // back to the minimum rather than wiped.
+    void clear() {
+        if (m_slots.size() > MIN_SLOTS && m_size * 8 < m_slots.size()) {
+            std::vector<uint64_t>(MIN_SLOTS, 0).swap(m_slots);
+        } else if (m_slots.empty()) {
+            m_slots.assign(MIN_SLOTS, 0);
+        } else {
+            std::memset(m_slots.data(), 0, m_slots.size() * sizeof(uint64_t));
+        }
+        m_size = 0;
+        m_hasZero = false;
+    }
+
+    // True if `key` was not in the set.
+    bool insert(uint64_t key) {
+        if (key == 0) { // 0 marks an empty slot
+            bool added = !m_hasZero;
+            m_hasZero = true;
+            return added;
+        }
+        if ((m_size + 1) * 2 > m_slots.size()) grow();
+        if (!place(m_slots, key)) return false;
+        m_size++;
+        return true;
+    }
+
+private:
+    static bool place(std::vector<uint64_t>& slots, uint64_t key) {
+        size_t mask = slots.size() - 1;
+        for (size_t i = (size_t)((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;; i = (i + 1) & mask) {
+            if (slots[i] == key) return false;
+            if (slots[i] == 0) {
+                slots[i] = key;
+                return true;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<uint64_t> bigger(m_slots.size() * 2, 0);
+        for (uint64_t key : m_slots)
+            if (key != 0) place(bigger, key);
+        m_slots.swap(bigger);
+    }
+
+    std::vector<uint64_t> m_slots;
+    size_t m_size = 0;
+    bool m_hasZero = false;
+};
+
+// Shared by the single-state and the lockstep search. `step(state, hold)` advances one
+// tick, `key` hashes a state for the visited set, `exitX` gives the X used for the goal
+// test and `emit` fills the result from the exit state. With an active guide both
+// children are stepped up front and the one `player` of which scores higher is tried
+// first. Probes for the tree estimator use the same `step`.
+template <class State, class Step, class Key, class ExitX, class Emit, class Player>
+bool depthFirst(const State& start, float goalX, int maxTicks, const Deadline& deadline,
+                Step step, Key key, ExitX exitX, Emit emit, Player player, const TickSearchOptions& options,
+                SegmentResult& out, TickSearchStats* stats) {
+    const ValueGuide* guide = options.guide;
+    const bool guided = guide && guide->active();
+
+    // Kept iterative: a section can be thousands of ticks deep.
+    struct Node {
+        State state;
+        uint8_t nextBranch = 0; // 0 = first child, 1 = second child, 2 = exhausted
+        bool holdFirst = false;
+        bool stepped = false;   // children below are valid (guided search only)
+        State child[2] = {};
+        StepOutcome outcome[2] = {};
+    };
+    std::vector<Node> stack;
+    stack.reserve((size_t)maxTicks + 1);
+    stack.emplace_back().state = start;
+
+    // The physics is deterministic, so a state we have already expanded either led to
+    // the goal (and we stopped) or cannot; there is no need to expand it again.
+    static thread_local VisitedSet visited;
+    BitStateSet* bitState = options.bitState;
+    if (bitState) bitState->clear();
+    else visited.clear();
+    auto markVisited = [&](uint64_t k) { return bitState ? bitState->insert(k) : visited.insert(k); };
+
+    Timeline seq;
+    seq.reserve(4096);
+    TickSearchStats local;
+
+    // A random walk from the start for the estimator, stepping both children of every
+    // node (TreeEstimate.hpp). Seeded the same way every search, so runs repeat.
+    TreeEstimator* estimator = options.estimator;
+    std::vector<uint8_t> probeAlive;
+    uint64_t rng = 0x9e3779b97f4a7c15ull;
+    auto probe = [&]() {
+        probeAlive.clear();
+        State s = start;
+        uint64_t steps = 0;
+        int depth = 0;
+        for (; depth < maxTicks; ++depth) {
+            State child[2];
+            uint8_t alive = 0;
+            bool goal = false;
+            for (int b = 0; b < 2; ++b) {
+                State c = s;
+                StepOutcome outcome = step(c, b == 1);
+                steps++;
+                if (outcome == StepOutcome::Dead) continue;
+                goal |= outcome == StepOutcome::Finished || exitX(c) >= goalX;
+                child[alive++] = c;
+            }
+            probeAlive.push_back(alive);
+            if (alive == 0 || goal) break;
+            rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+            s = child[alive == 2 ? rng >> 63 : 0];
+        }
+        // Ticks to the goal at the speed the walk moved.
+        float moved = exitX(s) - exitX(start);
+        double goalDepth = moved > 0.0f ? (double)depth * (goalX - exitX(start)) / moved : 0.0;
+        estimator->addProbe(probeAlive, goalDepth, steps, local.nodes);
+    };
+    if (estimator) estimator->begin((size_t)maxTicks);
+
+    bool found = false;
+    while (!stack.empty()) {
+        if (options.maxNodes && local.nodes >= options.maxNodes) break;
+        if ((local.nodes & 1023) == 0) {
+            if (deadline.expired()) break;
+            if (estimator) estimator->update(local.nodes);
+        }
+        if (estimator && estimator->probeDue(local.nodes)) probe();
+
+        Node& top = stack.back();
+        if (top.nextBranch == 2) {
+            stack.pop_back();
+            if (!stack.empty()) seq.pop_back();
+            continue;
+        }
+
+        if (guided && !top.stepped) {
+            for (int b = 0; b < 2; ++b) {
+                top.child[b] = top.state;
+                top.outcome[b] = step(top.child[b], b == 1);
+            }
+            local.nodes += 2;
+            top.stepped = true;
+            if (top.outcome[0] == StepOutcome::Alive && top.outcome[1] == StepOutcome::Alive) {
+                const PlayerState* states[2] = {&player(top.child[0]), &player(top.child[1])};
+                float scores[2];
+                guide->score(states, 2, scores);
+                top.holdFirst = scores[1] > scores[0];
+            }
+        }
+
+        bool click = (top.nextBranch++ == 1) != top.holdFirst;
+        State next;
+        StepOutcome outcome;
+        if (top.stepped) {
+            next = top.child[click];
+            outcome = top.outcome[click];
+        } else {
+            next = top.state;
+            outcome = step(next, click);
+            local.nodes++;
+        }
+        if (outcome == StepOutcome::Dead) continue;
+
+        seq.push_back(click);
+        if (outcome == StepOutcome::Finished || exitX(next) >= goalX) {
+            out.inputs = seq;
+            emit(next, out);
+            out.finished = outcome == StepOutcome::Finished;
+            found = true;
+            break;
+        }
+        if (stack.size() >= (size_t)maxTicks || !markVisited(key(next))) {
+            if (stack.size() < (size_t)maxTicks) {
+                local.duplicates++;
+                if (estimator) estimator->child(stack.size() - 1, false);
+            }
+            seq.pop_back();
+            continue;
+        }
+        if (estimator) estimator->child(stack.size() - 1, true);
+        stack.emplace_back().state = next;
+    }
+
+    if (estimator) estimator->end();
+    if (stats) {
+        stats->nodes += local.nodes;
+        stats->duplicates += local.duplicates;
+        if (bitState) stats->omissions += bitState->expectedOmissions();
+    }
+    return found;
+}
+
+} // namespace
+
+bool searchTicks(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& start,
+                 float goalX, float dt, int maxTicks, const Deadline& deadline,
+                 SegmentResult& out, TickSearchStats* stats, const TickSearchOptions& options) {
+    return depthFirst(
+        start, goalX, maxTicks, deadline,
+        [&](PlayerState& s, bool hold) { return stepPlayer(level, broadphase, s, hold, dt); },
+        [](const PlayerState& s) { return stateKey(s); },
+        [](const PlayerState& s) { return s.x; },
+        [](const PlayerState& s, SegmentResult& r) { r.exit = s; },
+        [](const PlayerState& s) -> const PlayerState& { return s; }, options,
+        out, stats);
+}
+
+bool searchTicksLockstep(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                         const LaneStates& start, float goalX, float dt, int maxTicks, const Deadline& deadline,
+                         SegmentResult& out, TickSearchStats* stats, const TickSearchOptions& options) {
+    return depthFirst(
+        start, goalX, maxTicks, deadline,
+        [&](LaneStates& l, bool hold) { return stepLanes(level, broadphase, config, l, hold, dt); },
+        [](const LaneStates& l) { return lanesKey(l); },
+        [](const LaneStates& l) { return l.minX(); },
+        [](const LaneStates& l, SegmentResult& r) { r.exit = l.lane[0]; r.exitLanes = l; },
+        [](const LaneStates& l) -> const PlayerState& { return l.lane[0]; }, options,
+        out, stats);
+}
+
+} // namespace amm
@@ -0,0 +1,55 @@
+// src/TickSearch.hpp
+// AutomaticMacroMaker - per-tick depth-first search over hold / release
+// Developer: entity12208
+//
+// The general fallback: it handles every gamemode but branches on every tick, so it
+// relies on the visited set to stay tractable. Ground sections go through the much
+// smaller SurfaceGraph instead.
+//
+// The lockstep variant is the robust-mode fallback (see Lockstep.hpp).
+
+#pragma once
+
+#include "Segment.hpp"
+
+#include <cstdint>
+
+namespace amm {
+
+class BitStateSet;
+class TreeEstimator;
+struct ValueGuide;
+
+struct TickSearchStats {
+    uint64_t nodes = 0;      // physics steps taken
+    uint64_t duplicates = 0; // states pruned by the visited set
+    double omissions = 0.0;  // bit-state mode: expected distinct states pruned by mistake
+};
+
+struct TickSearchOptions {
+    // Orders the branches when active (ValueModel.hpp); release first otherwise.
+    const ValueGuide* guide = nullptr;
+    // Lossy visited set to use instead of the exact one (BitStateSet.hpp). Cleared at
+    // the start of every search, so one bitmap can serve a whole solve.
+    BitStateSet* bitState = nullptr;
+    // Estimates the size of each search tree while it runs (TreeEstimate.hpp).
+    TreeEstimator* estimator = nullptr;
+    // Gives up after this many physics steps (0 = no limit). Unlike the deadline, the
+    // result does not depend on how fast the machine is.
+    uint64_t maxNodes = 0;
+};
+
+// Searches from `start` until the player passes goalX (or finishes the level).
+// Returns false on timeout / exhaustion.
+bool searchTicks(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& start,
+                 float goalX, float dt, int maxTicks, const Deadline& deadline,
+                 SegmentResult& out, TickSearchStats* stats = nullptr, const TickSearchOptions& options = {});
+
+// Same search with every branch simulated at all rates of `config` (see Lockstep.hpp).
+// The goal is reached once the slowest lane passes goalX; out.exitLanes holds the lanes.
+bool searchTicksLockstep(const LevelSnapshot& level, const Broadphase& broadphase, const MultiRateConfig& config,
+                         const LaneStates& start, float goalX, float dt, int maxTicks, const Deadline& deadline,
+                         SegmentResult& out, TickSearchStats* stats = nullptr,
+                         const TickSearchOptions& options = {});
+
+} // namespace amm
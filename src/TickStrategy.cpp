@@ -0,0 +1,79 @@
+// src/TickStrategy.cpp
+// AutomaticMacroMaker - the per-tick search run over the whole level at once
+// Developer: entity12208
+//
+// No section solvers and no backtracking between sections: one depth-first search
+// (the lockstep one in robust mode) from the start to the level end. Slower than the
+// section strategy on long levels, but it has no section boundaries to get stuck at,
+// which makes it a useful baseline for benchmarks. The search cannot be paused, so
+// the first step() runs it to the end regardless of the budget.
+
+#include "Strategy.hpp"
+#include "TickSearch.hpp"
+
+namespace amm {
+
+namespace {
+
+class TickStrategy final : public SolverStrategy {
+public:
+    void prepare(const SolveContext& context) override {
+        m_ctx = context;
+        m_config = context.settings.robust ? MultiRateConfig::robust() : MultiRateConfig::single();
+        m_options.guide = context.settings.guide;
+        m_options.bitState = context.settings.bitState;
+        m_options.estimator = context.settings.estimator;
+    }
+
+    bool step(uint64_t) override {
+        if (m_done) return false;
+        m_done = true;
+        const LevelSnapshot& level = *m_ctx.level;
+        const SolverSettings& cfg = m_ctx.settings;
+        PlayerState initial = initialState(level);
+        SegmentResult r;
+        bool ok = cfg.robust
+            ? searchTicksLockstep(level, *m_ctx.broadphase, m_config, spreadLanes(initial, m_config), level.endX,
+                  cfg.dt, cfg.maxTicks, m_ctx.deadline, r, &m_stats, m_options)
+            : searchTicks(level, *m_ctx.broadphase, initial, level.endX, cfg.dt, cfg.maxTicks, m_ctx.deadline, r,
+                  &m_stats, m_options);
+        if (ok && r.finished) m_solution = std::move(r.inputs);
+        return false;
+    }
+
+    SolveProgress progress() const override {
+        SolveProgress p;
+        p.fraction = m_solution.empty() ? 0.0f : 1.0f;
+        p.work = m_stats.nodes;
+        p.solutions = m_solution.empty() ? 0 : 1;
+        p.memory = m_solution.capacity();
+        return p;
+    }
+
+    std::vector<Timeline> extract() override {
+        if (m_solution.empty()) return {};
+        return {m_solution};
+    }
+
+    std::string report() const override {
+        return std::to_string(m_stats.nodes) + " tick nodes, " + std::to_string(m_stats.duplicates) +
+            " duplicates, " + std::to_string(m_config.count) + " rate lanes" + omissions(m_ctx.settings, m_stats) +
+            probes(m_ctx.settings, m_stats);
+    }
+
+private:
+    SolveContext m_ctx;
+    MultiRateConfig m_config;
+    TickSearchOptions m_options;
+    TickSearchStats m_stats;
+    Timeline m_solution;
+    bool m_done = false;
+};
+
+} // namespace
+
+std::unique_ptr<SolverStrategy> makeTickStrategy() {
+    return std::make_unique<TickStrategy>();
+}
+
+} // namespace amm
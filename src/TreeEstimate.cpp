@@ -0,0 +1,108 @@
+// src/TreeEstimate.cpp
+// AutomaticMacroMaker - online size estimate of the tick search tree, for ETAs
+// Developer: entity12208
+
+#include "TreeEstimate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace amm {
+
+static constexpr uint64_t MIN_DEPTH_SAMPLES = 32; // below this a depth uses the overall pruning rate
+static constexpr double MAX_ESTIMATE = 1.0e18;
+
+static double logAdd(double a, double b) {
+    if (a < b) std::swap(a, b);
+    if (b == -std::numeric_limits<double>::infinity()) return a;
+    return a + std::log1p(std::exp(b - a));
+}
+
+void TreeEstimator::begin(size_t maxDepth) {
+    m_alive.assign(maxDepth + 1, 0);
+    m_kept.assign(maxDepth + 1, 0);
+    m_logSum.assign(maxDepth + 1, -std::numeric_limits<double>::infinity());
+    m_depth = 0;
+    m_goalDepth = 0.0;
+    m_probeCount = m_moved = 0;
+    m_nextProbe = WARMUP_NODES;
+    m_nextUpdate = UPDATE_NODES;
+    m_searched.store(0, std::memory_order_relaxed);
+    m_estimate.store(0.0, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_relaxed);
+}
+
+void TreeEstimator::addProbe(const std::vector<uint8_t>& alive, double goalDepth, uint64_t steps, uint64_t nodes) {
+    // Nodes at depth d: the product of the survivors at depths 0 .. d-1 of the walk.
+    double logProduct = 0.0;
+    size_t depth = std::min(alive.size(), m_logSum.size());
+    for (size_t d = 0; d < depth; ++d) {
+        m_logSum[d] = logAdd(m_logSum[d], logProduct);
+        if (alive[d] == 0) break;
+        logProduct += std::log((double)alive[d]);
+    }
+    m_depth = std::max(m_depth, depth);
+    m_probeCount++;
+    if (goalDepth > 0.0) {
+        m_goalDepth += goalDepth;
+        m_moved++;
+    }
+    m_nextProbe = nodes + std::max<uint64_t>(steps, 1) * NODES_PER_PROBE_STEP;
+    m_probes.fetch_add(1, std::memory_order_relaxed);
+    m_probeSteps.fetch_add(steps, std::memory_order_relaxed);
+    recompute();
+    m_searched.store(nodes, std::memory_order_relaxed);
+    if (m_listener) m_listener();
+}
+
+void TreeEstimator::recompute() {
+    uint64_t alive = 0, kept = 0, layers = 0;
+    for (size_t d = 0; d < m_kept.size(); ++d) {
+        alive += m_alive[d];
+        kept += m_kept[d];
+        layers += m_kept[d] != 0;
+    }
+    double overall = alive ? (double)kept / (double)alive : 1.0;
+    double logProbes = std::log((double)m_probeCount);
+    double width = layers ? std::max(1.0, (double)kept / (double)layers) : 1.0;
+    size_t goal = m_moved ? (size_t)(m_goalDepth / (double)m_moved) : m_depth;
+    goal = std::clamp(goal, m_depth, m_logSum.size());
+    double logKeep = 0.0, nodes = 0.0;
+    for (size_t d = 0; d < goal; ++d) {
+        double logProbed = d < m_depth ? logKeep + m_logSum[d] - logProbes : std::log(width);
+        double probed = logProbed < std::log(width) ? std::exp(logProbed) : width;
+        nodes += std::max(probed, d > 0 ? (double)m_kept[d - 1] : 1.0);
+        if (d < m_depth) {
+            double keep = m_alive[d] >= MIN_DEPTH_SAMPLES ? (double)m_kept[d] / (double)m_alive[d] : overall;
+            logKeep += std::log(keep);
+        }
+    }
+    // Every node in the tree steps both its children.
+    m_estimate.store(std::min(2.0 * nodes, MAX_ESTIMATE), std::memory_order_relaxed);
+}
+
+void TreeEstimator::update(uint64_t nodes) {
+    m_searched.store(nodes, std::memory_order_relaxed);
+    if (nodes < m_nextUpdate) return;
+    m_nextUpdate = nodes + UPDATE_NODES;
+    if (m_listener) m_listener();
+}
+
+void TreeEstimator::end() {
+    m_searched.store(0, std::memory_order_relaxed);
+    m_running.store(false, std::memory_order_relaxed);
+}
+
+double TreeEstimator::remaining() const {
+    if (!m_running.load(std::memory_order_relaxed)) return 0.0;
+    return std::max(0.0, estimate() - (double)searched());
+}
+
+double predictWork(double work, float fraction, double searchRemaining) {
+    double extrapolated = fraction > 0.0f ? work / std::min(fraction, 1.0f) : 0.0;
+    if (searchRemaining <= 0.0 && extrapolated <= 0.0) return 0.0;
+    return std::max(work + searchRemaining, extrapolated);
+}
+
+} // namespace amm
@@ -0,0 +1,95 @@
+// src/TreeEstimate.hpp
+// AutomaticMacroMaker - online size estimate of the tick search tree, for ETAs
+// Developer: entity12208
+//
+// A stuck tick search looks the same as one about to finish. The estimator predicts
+// how large the tree of the running search is, so the mod can show a percentage and an
+// ETA and the CLI can export them.
+//
+// It combines estimates from two sources:
+//  - probes (Knuth, "Estimating the efficiency of backtrack programs"): random walks
+//    from the search root that step both children of every node and follow a random
+//    surviving one, recording how many survived at each depth. The product of those
+//    counts estimates the number of nodes at that depth, averaged over the probes. The
+//    walks also give the ticks to the goal, from how fast they moved towards it;
+//  - the search itself: the share of surviving children the visited set pruned at each
+//    depth, which a probe cannot see (it depends on the search order), and how many
+//    distinct states it has kept per depth so far.
+// The visited set turns the tree into a graph with a bounded number of states per tick,
+// so the estimate for a depth is the probes' count scaled by the pruning, capped at the
+// average number of states the search kept per depth (and at least what it kept at
+// this one). Depths past where the probes died count as that average.
+// Probes start once the search is past WARMUP_NODES and are spaced so they never cost
+// more than 1 / NODES_PER_PROBE_STEP of the search. They do not count as search work.
+//
+// The search thread writes; searched(), estimate() and the totals may be read from any
+// thread.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace amm {
+
+class TreeEstimator {
+public:
+    static constexpr uint64_t WARMUP_NODES = 1 << 16;     // smaller searches are not probed
+    static constexpr uint64_t NODES_PER_PROBE_STEP = 128; // keeps probes under 1% of the search
+    static constexpr uint64_t UPDATE_NODES = 1 << 16;     // listener interval, in search nodes
+
+    // Called from the search thread every UPDATE_NODES nodes and after every probe.
+    void setListener(std::function<void()> listener) { m_listener = std::move(listener); }
+
+    // Called by the search (TickSearch.cpp).
+    void begin(size_t maxDepth);
+    // A child of a node at `depth` survived its step; `kept` if the visited set let it through.
+    void child(size_t depth, bool kept) {
+        m_alive[depth]++;
+        m_kept[depth] += kept;
+    }
+    bool probeDue(uint64_t nodes) const { return nodes >= m_nextProbe; }
+    // One probe: `alive[d]` children survived at depth d of the walk, which it expects
+    // to reach the goal after `goalDepth` ticks (0 if it did not move); it cost `steps`.
+    void addProbe(const std::vector<uint8_t>& alive, double goalDepth, uint64_t steps, uint64_t nodes);
+    void update(uint64_t nodes);
+    void end();
+
+    // Physics steps of the running search (0 between searches), and the predicted steps
+    // of its whole tree (0 before the first probe; the last search's between searches).
+    uint64_t searched() const { return m_searched.load(std::memory_order_relaxed); }
+    double estimate() const { return m_estimate.load(std::memory_order_relaxed); }
+    // Predicted steps the running search still needs; 0 if unknown or between searches.
+    double remaining() const;
+
+    // Totals over every search since construction.
+    uint64_t probes() const { return m_probes.load(std::memory_order_relaxed); }
+    uint64_t probeSteps() const { return m_probeSteps.load(std::memory_order_relaxed); }
+
+private:
+    void recompute();
+
+    std::vector<uint64_t> m_alive, m_kept; // per depth, from the search
+    std::vector<double> m_logSum;          // per depth, log of the probes' summed products
+    size_t m_depth = 0;                    // deepest depth a probe reached
+    double m_goalDepth = 0.0;              // summed over the probes that moved
+    uint64_t m_probeCount = 0, m_moved = 0; // probes of the running search
+    uint64_t m_nextProbe = WARMUP_NODES, m_nextUpdate = UPDATE_NODES;
+    std::function<void()> m_listener;
+
+    std::atomic<uint64_t> m_searched{0};
+    std::atomic<double> m_estimate{0.0};
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_probes{0}, m_probeSteps{0};
+};
+
+// Total work units predicted for a solve that has spent `work` (including the running
+// search's) and reached `fraction` of the level: the larger of the work plus what the
+// running search still needs, and the work extrapolated over the level. 0 if neither
+// is known yet.
+double predictWork(double work, float fraction, double searchRemaining);
+
+} // namespace amm
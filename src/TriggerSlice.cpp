@@ -0,0 +1,69 @@
+// src/TriggerSlice.cpp
+// AutomaticMacroMaker - keep only the triggers that can change what the player hits
+// Developer: entity12208
+
+#include "TriggerSlice.hpp"
+
+#include <algorithm>
+
+namespace amm {
+
+static bool movesTarget(TriggerKind k) {
+    return k == TriggerKind::Move || k == TriggerKind::Rotate || k == TriggerKind::Follow ||
+        k == TriggerKind::FollowPlayerY;
+}
+
+TriggerSlice sliceTriggers(const std::vector<TriggerInfo>& triggers, const std::unordered_set<int>& gameplayGroups) {
+    std::unordered_set<int> relevant = gameplayGroups; // groups whose motion / state matters
+    std::unordered_set<int> activating;                // groups holding a kept trigger
+    std::unordered_set<int> spawnedPlayer;             // groups holding a spawned player trigger
+    std::unordered_set<int> spawnedGroups;             // targets of kept spawn triggers
+    for (const TriggerInfo& t : triggers)
+        if (t.kind == TriggerKind::Player && t.spawned) spawnedPlayer.insert(t.groups.begin(), t.groups.end());
+    std::vector<bool> keep(triggers.size(), false);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < triggers.size(); ++i) {
+            if (keep[i]) continue;
+            const TriggerInfo& t = triggers[i];
+            bool k = false;
+            switch (t.kind) {
+                case TriggerKind::Player:
+                    k = !t.spawned || std::any_of(t.groups.begin(), t.groups.end(),
+                                                  [&](int g) { return spawnedGroups.count(g) > 0; });
+                    break;
+                case TriggerKind::Spawn:
+                    k = t.target && (activating.count(t.target) || spawnedPlayer.count(t.target));
+                    break;
+                case TriggerKind::Toggle:
+                    k = t.target && (relevant.count(t.target) || activating.count(t.target));
+                    break;
+                case TriggerKind::Decoration: break;
+                default: k = t.target && relevant.count(t.target); break;
+            }
+            if (!k) continue;
+            keep[i] = true;
+            changed = true;
+            for (int g : t.groups) activating.insert(g);
+            if (t.kind == TriggerKind::Spawn) spawnedGroups.insert(t.target);
+            if (t.source && movesTarget(t.kind)) relevant.insert(t.source);
+        }
+    }
+
+    TriggerSlice slice;
+    for (size_t i = 0; i < triggers.size(); ++i) {
+        if (!keep[i]) {
+            slice.dropped++;
+            continue;
+        }
+        slice.kept.push_back((uint32_t)i);
+        const TriggerInfo& t = triggers[i];
+        if (movesTarget(t.kind)) slice.moved.insert(t.target);
+        else if (t.kind == TriggerKind::Toggle) slice.toggled.insert(t.target);
+    }
+    return slice;
+}
+
+} // namespace amm
@@ -0,0 +1,56 @@
+// src/TriggerSlice.hpp
+// AutomaticMacroMaker - keep only the triggers that can change what the player hits
+// Developer: entity12208
+//
+// Most triggers in a modern level are decoration: colors, pulses, or moves of groups
+// with nothing collidable in them. The solver only cares about triggers that can move,
+// rotate or switch off gameplay objects (solids, hazards, orbs, pads, portals) or act on
+// the player directly. sliceTriggers() is a static pass over the trigger graph that
+// finds those:
+//  - a move / rotate / follow / toggle trigger is kept when its target group holds
+//    gameplay objects;
+//  - the group a kept rotate or follow trigger takes its motion from (rotation center,
+//    followed group) becomes relevant in turn, so the triggers moving it are kept too;
+//  - a spawn or toggle trigger is kept when its target group holds a kept trigger,
+//    since it decides whether that trigger runs;
+//  - player triggers (gravity) are kept unless they only run when spawned and no kept
+//    spawn trigger targets them; a spawn trigger targeting one is kept.
+// It iterates to a fixed point. Only the groups the kept triggers act on end up
+// dynamic in the compiled level (CompiledLevel.hpp); everything else is static.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace amm {
+
+enum class TriggerKind : uint8_t {
+    Move, Rotate, Follow, FollowPlayerY, // move their target group
+    Toggle,                              // enables / disables their target group
+    Spawn,                               // runs the triggers in their target group
+    Player,                              // act on the player, no target group
+    Decoration,                          // color, pulse, alpha, shake, ...
+};
+
+struct TriggerInfo {
+    TriggerKind kind = TriggerKind::Decoration;
+    int target = 0;          // target group, 0 if none
+    int source = 0;          // rotate center / followed group, 0 if none
+    std::vector<int> groups; // groups the trigger object itself is in
+    bool spawned = false;    // runs only when spawned, not as the player passes it
+};
+
+struct TriggerSlice {
+    std::vector<uint32_t> kept;        // indices into the trigger list, ascending
+    std::unordered_set<int> moved;     // groups moved by kept triggers
+    std::unordered_set<int> toggled;   // groups switched on / off by kept triggers
+    size_t dropped = 0;
+};
+
+// `gameplayGroups`: every group that contains a gameplay object.
+TriggerSlice sliceTriggers(const std::vector<TriggerInfo>& triggers, const std::unordered_set<int>& gameplayGroups);
+
+} // namespace amm
@@ -0,0 +1,191 @@
+// src/ValueModel.cpp
+// AutomaticMacroMaker - learned estimate of how likely a player state is to survive
+// Developer: entity12208
+
+#include "ValueModel.hpp"
+#include "Simd.hpp"
+#include "TickSearch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace amm {
+
+static constexpr int AHEAD_CELLS = 8;      // raster columns looked at in front of the player
+static constexpr int VERTICAL_CELLS = 6;   // raster rows looked at above / below
+static constexpr float SURFACE_RANGE = 300.0f;
+static constexpr float VELOCITY_SCALE = 1.0f / 1000.0f;
+static constexpr uint64_t LABEL_NODES = 300000; // search steps per label before the sample is dropped
+static constexpr int RANDOM_WALKS = 16;    // walks per level without a solution
+static constexpr const char* MODEL_HEADER = "amm-value-model 1";
+
+void extractFeatures(const LevelSnapshot& level, const HazardRaster& raster, const PlayerState& s, float* out) {
+    const Section& sec = level.sections[s.section];
+    int up = s.flipped ? -1 : 1;
+    int col = raster.columnOf(s.x), row = raster.rowOf(s.y);
+
+    int ahead = 1;
+    while (ahead <= AHEAD_CELLS && !raster.blocked(col + ahead, row)) ++ahead;
+
+    auto vertical = [&](int dir) {
+        int k = 1;
+        for (; k <= VERTICAL_CELLS; ++k) {
+            int r = row + k * dir;
+            if (raster.blocked(col, r) || raster.blocked(col + 1, r) || raster.blocked(col + 2, r)) break;
+        }
+        return (float)(k - 1) / VERTICAL_CELLS;
+    };
+
+    float toFloor = s.flipped ? sec.ceilY - s.y : s.y - sec.floorY;
+    float toCeil = s.flipped ? s.y - sec.floorY : sec.ceilY - s.y;
+
+    out[0] = 1.0f;
+    out[1] = (float)(ahead - 1) / AHEAD_CELLS;
+    out[2] = vertical(up);
+    out[3] = vertical(-up);
+    out[4] = std::clamp(toFloor / SURFACE_RANGE, 0.0f, 1.0f);
+    out[5] = std::clamp(toCeil / SURFACE_RANGE, 0.0f, 1.0f);
+    out[6] = s.vy * (float)up * VELOCITY_SCALE;
+    out[7] = s.onGround ? 1.0f : 0.0f;
+    for (int m = 0; m < 8; ++m) out[8 + m] = (int)s.mode == m ? 1.0f : 0.0f;
+}
+
+template <class L>
+static void logitsKernel(const float* weights, const FeatureBlock* blocks, size_t count, float* out) {
+    for (size_t b = 0; b < count; ++b) {
+        auto acc = L::splat(0.0f);
+        for (int k = 0; k < FEATURE_COUNT; ++k)
+            acc = L::add(acc, L::mul(L::splat(weights[k]), L::load(blocks[b].f[k])));
+        L::store(out + b * 4, acc);
+    }
+}
+
+void ValueModel::logits(const FeatureBlock* blocks, size_t count, float* out) const {
+    if (simd::activeBackend() == simd::Backend::Scalar) logitsKernel<simd::ScalarLanes>(m_weights, blocks, count, out);
+    else logitsKernel<simd::NativeLanes>(m_weights, blocks, count, out);
+}
+
+static float sigmoid(float z) {
+    return 1.0f / (1.0f + std::exp(-z));
+}
+
+float ValueModel::survival(const float* features) const {
+    float z = 0.0f;
+    for (int k = 0; k < FEATURE_COUNT; ++k) z += m_weights[k] * features[k];
+    return sigmoid(z);
+}
+
+float ValueModel::fit(std::vector<TrainingSample> samples, int epochs, float learningRate, uint32_t seed) {
+    std::mt19937 rng(seed);
+    float loss = 0.0f;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        std::shuffle(samples.begin(), samples.end(), rng);
+        loss = 0.0f;
+        for (const auto& s : samples) {
+            float p = survival(s.f);
+            float err = p - s.label;
+            for (int k = 0; k < FEATURE_COUNT; ++k) m_weights[k] -= learningRate * err * s.f[k];
+            loss -= s.label > 0.5f ? std::log(std::max(p, 1e-6f)) : std::log(std::max(1.0f - p, 1e-6f));
+        }
+        if (!samples.empty()) loss /= (float)samples.size();
+    }
+    m_trained = !samples.empty();
+    return loss;
+}
+
+bool ValueModel::load(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    std::string header;
+    if (!in || !std::getline(in, header) || header != MODEL_HEADER) return false;
+    float weights[FEATURE_COUNT];
+    for (float& w : weights)
+        if (!(in >> w) || !std::isfinite(w)) return false;
+    std::copy(weights, weights + FEATURE_COUNT, m_weights);
+    m_trained = true;
+    return true;
+}
+
+bool ValueModel::save(const std::filesystem::path& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << MODEL_HEADER << "\n";
+    for (int k = 0; k < FEATURE_COUNT; ++k) out << m_weights[k] << (k + 1 < FEATURE_COUNT ? " " : "\n");
+    return (bool)out;
+}
+
+void ValueGuide::score(const PlayerState* const* states, size_t n, float* out) const {
+    FeatureBlock block;
+    float features[FEATURE_COUNT];
+    for (size_t i = 0; i < n && i < 4; ++i) {
+        extractFeatures(*level, *raster, *states[i], features);
+        for (int k = 0; k < FEATURE_COUNT; ++k) block.f[k][i] = features[k];
+    }
+    float logits[4];
+    model->logits(&block, 1, logits);
+    std::copy(logits, logits + std::min<size_t>(n, 4), out);
+}
+
+// Labels `s`: 1 if some input continuation survives `horizon` ticks, 0 if none does,
+// -1 if the search used up LABEL_NODES before deciding. A step budget rather than a
+// time budget keeps the labels, and the trained model, the same on every machine.
+static int labelState(const LevelSnapshot& level, const Broadphase& broadphase, const PlayerState& s,
+                      int horizon, float dt) {
+    TickSearchOptions options;
+    options.maxNodes = LABEL_NODES;
+    TickSearchStats stats;
+    SegmentResult r;
+    if (searchTicks(level, broadphase, s, s.x + s.speed * dt * (float)horizon, dt, horizon + 1, Deadline{}, r,
+            &stats, options))
+        return 1;
+    return stats.nodes >= LABEL_NODES ? -1 : 0;
+}
+
+void collectSamples(const LevelSnapshot& level, const Broadphase& broadphase, const HazardRaster& raster,
+                    const Timeline& solution, int horizon, int stride, float dt, uint32_t seed,
+                    std::vector<TrainingSample>& out) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    auto emit = [&](const PlayerState& s) {
+        int label = labelState(level, broadphase, s, horizon, dt);
+        if (label < 0) return;
+        TrainingSample sample;
+        extractFeatures(level, raster, s, sample.f);
+        sample.label = (float)label;
+        out.push_back(sample);
+    };
+
+    // Walk the solution (or a few random policies) and branch a random continuation off
+    // it every `stride` ticks, so both survivable and doomed states get sampled.
+    int walks = solution.empty() ? RANDOM_WALKS : 1;
+    for (int walk = 0; walk < walks; ++walk) {
+        PlayerState s = initialState(level);
+        bool hold = false;
+        for (size_t tick = 0;; ++tick) {
+            if (tick % (size_t)stride == 0) {
+                emit(s);
+                PlayerState branch = s;
+                int length = 1 + (int)(rng() % (uint32_t)stride);
+                bool branchHold = unit(rng) < 0.5f;
+                bool alive = true;
+                for (int k = 0; k < length && alive; ++k) {
+                    if (unit(rng) < 0.2f) branchHold = !branchHold;
+                    alive = stepPlayer(level, broadphase, branch, branchHold, dt) == StepOutcome::Alive;
+                }
+                if (alive) emit(branch);
+            }
+
+            if (solution.empty()) {
+                if (unit(rng) < 0.15f) hold = !hold;
+            } else {
+                if (tick >= solution.size()) break;
+                hold = solution[tick] != 0;
+            }
+            if (stepPlayer(level, broadphase, s, hold, dt) != StepOutcome::Alive) break;
+        }
+    }
+}
+
+} // namespace amm
@@ -0,0 +1,82 @@
+// src/ValueModel.hpp
+// AutomaticMacroMaker - learned estimate of how likely a player state is to survive
+// Developer: entity12208
+//
+// A logistic model over a handful of local features: free cells ahead of the player
+// and above / below it (read from the HazardRaster), distance to the section floor and
+// ceiling, vertical velocity, whether the player is grounded, and the gamemode. All
+// features are taken in the player's gravity frame, so a flipped state looks like the
+// mirrored unflipped one. States are scored four at a time (Simd.hpp).
+//
+// The model only orders work; it never decides whether a state is valid. An untrained
+// model (no weights file) leaves every search in its original order. Weights are fitted
+// offline by the headless CLI (`macromaker-cli train`) from corpus dumps.
+
+#pragma once
+
+#include "HazardRaster.hpp"
+#include "Segment.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace amm {
+
+static constexpr int FEATURE_COUNT = 16;
+
+// Features of four states, feature-major so a lane holds one state.
+struct FeatureBlock {
+    float f[FEATURE_COUNT][4] = {};
+};
+
+// Writes the FEATURE_COUNT features of `s` (see the header comment for the layout).
+void extractFeatures(const LevelSnapshot& level, const HazardRaster& raster, const PlayerState& s, float* out);
+
+struct TrainingSample {
+    float f[FEATURE_COUNT];
+    float label; // 1 = survived the horizon, 0 = every continuation died
+};
+
+class ValueModel {
+public:
+    // Logits (not probabilities: only the order matters to the solvers) of `count`
+    // blocks; out receives 4 values per block.
+    void logits(const FeatureBlock* blocks, size_t count, float* out) const;
+    float survival(const float* features) const;
+
+    bool trained() const { return m_trained; }
+
+    // Logistic regression by plain SGD; returns the final mean log loss.
+    float fit(std::vector<TrainingSample> samples, int epochs, float learningRate, uint32_t seed);
+
+    // Text file: a header line and FEATURE_COUNT weights. load() returns false (and
+    // leaves the model untrained) if the file is missing or malformed.
+    bool load(const std::filesystem::path& path);
+    bool save(const std::filesystem::path& path) const;
+
+private:
+    float m_weights[FEATURE_COUNT] = {};
+    bool m_trained = false;
+};
+
+// A trained model together with the raster its features are read from. Searches take
+// an optional guide and keep their default order when it is inactive.
+struct ValueGuide {
+    const LevelSnapshot* level = nullptr;
+    const ValueModel* model = nullptr;
+    const HazardRaster* raster = nullptr;
+
+    bool active() const { return level && model && raster && model->trained(); }
+    // Scores up to 4 states at once.
+    void score(const PlayerState* const* states, size_t n, float* out) const;
+};
+
+// Labelled states for training. From every `stride`-th tick of `solution` (or of a
+// random walk when there is none) a random continuation is tried; the state is a
+// positive if some continuation survives `horizon` ticks.
+void collectSamples(const LevelSnapshot& level, const Broadphase& broadphase, const HazardRaster& raster,
+                    const Timeline& solution, int horizon, int stride, float dt, uint32_t seed,
+                    std::vector<TrainingSample>& out);
+
+} // namespace amm
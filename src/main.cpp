@@ -1,20 +1,27 @@
 // src/main.cpp
-// AutomaticMacroMaker - single-file mod implementation
+// AutomaticMacroMaker - mod glue (UI, snapshot extraction, recording/export)
 // Developer: entity12208
 //
-// Single-file mod that adds an "M" button in PlayLayer. Pressing it:
+// Adds an "M" button in PlayLayer. Pressing it:
 //  - Pauses the live game (on main thread).
-//  - Takes a snapshot (on main thread).
-//  - Spawns a background thread that runs a pure-compute solver (NO engine calls).
-//  - When solver returns a candidate input sequence, scheduling on main thread to
-//    run the deterministic simulation using the engine's recording APIs and produce
-//    an in-engine replay which we then export to a .gdr file in the user's mods dir.
+//  - Compiles the level once per session (LevelCache.hpp) and rebases it onto the live
+//    player and trigger-moved objects, giving an engine-free amm::LevelSnapshot.
+//  - Spawns a background thread (NO engine calls) that first checks the persistent
+//    solution cache (SolutionCache.hpp), then prepares the solve as a task graph
+//    (broadphase, feasibility scan, value model) and runs the solver strategy picked in
+//    the settings from the registry in Strategy.hpp: sections (surface graph, flight
+//    grid, tick search fallback), ticks, horizon or repair.
+//  - When the solver returns its input sequences, schedules back to the main thread to
+//    replay them through the engine's recording APIs and export the first one that
+//    survives to a .gdr file in the user's mods dir.
+// With idle pre-solving on, levels the player leaves after a press are solved in the
+// background between levels (IdleSolver.hpp), so the next press on them only replays
+// the cache.
 //
 // Notes:
-//  - All engine / PlayLayer calls happen on the main thread via performFunctionInCocosThread.
-//  - The background solver receives a *copy* of the deterministic level/model state
-//    (you can implement a faster clone if needed); the provided solver here is a simple
-//    DFS/IDDFS with timeout and serves as a starting point for further optimization.
+//  - All engine / PlayLayer calls happen on the main thread via performFunctionInCocosThread,
+//    and their cost is tracked by the main-thread profiler (MainThreadProfiler.hpp).
+//  - Everything outside this file is engine-free and builds headless with the CLI.
 //
 //  If you see small compile errors about method names like `startRecording` or
 //  `takeStateSnapshot`, tell me the exact compiler error and I will patch the exact binding name.
@@ -24,12 +31,38 @@
 #include <Geode/modify/PlayLayer.hpp>
 #include <Geode/loader/Dirs.hpp>
 #include <cocos2d.h>
+#include <algorithm>
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <functional>
 #include <fstream>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+
+#include "BitStateSet.hpp"
+#include "BoxMerge.hpp"
+#include "CollisionMemo.hpp"
+#include "Feasibility.hpp"
+#include "Collision.hpp"
+#include "CompiledLevel.hpp"
+#include "HazardRaster.hpp"
+#include "IdleSolver.hpp"
+#include "LevelCache.hpp"
+#include "LevelSnapshot.hpp"
+#include "MainThreadProfiler.hpp"
+#include "Physics.hpp"
+#include "Segment.hpp"
+#include "SnapshotIO.hpp"
+#include "SolutionCache.hpp"
+#include "Strategy.hpp"
+#include "TaskGraph.hpp"
+#include "TreeEstimate.hpp"
+#include "TriggerSlice.hpp"
+#include "ValueModel.hpp"
 
 using namespace geode::prelude;
 using Clock = std::chrono::steady_clock;
@@ -37,11 +70,350 @@ using Clock = std::chrono::steady_clock;
 static constexpr float SIM_DT = 1.0f / 60.0f;
 static constexpr int MAX_SEARCH_FRAMES = 60 * 60 * 2; // safety cap
 static constexpr int SOLVER_TIMEOUT_MS = 40 * 1000;   // 40 seconds
+static constexpr uint64_t STEP_BUDGET = 50000;       // strategy work units per step (Strategy.hpp)
+static constexpr int STATUS_INTERVAL_MS = 250;       // status label updates while solving
+static constexpr int IDLE_TIMEOUT_MS = 5 * 60 * 1000; // per level pre-solved in the background
+static constexpr size_t IDLE_RETRY_LEVELS = 4;       // failed levels queued again at startup
+static constexpr float DEG_TO_RAD = 3.14159265f / 180.0f;
 
 struct FrameInput {
     bool click = false;
 };
 
+// ---------- Snapshot extraction (main thread only) ----------
+
+static bool hitKindFor(GameObject* obj, amm::HitKind& out) {
+    switch (obj->m_objectType) {
+        case GameObjectType::Solid:
+        case GameObjectType::Slope: out = amm::HitKind::Solid; return true;
+        case GameObjectType::Hazard: out = amm::HitKind::Hazard; return true;
+        case GameObjectType::YellowJumpPad: out = amm::HitKind::YellowPad; return true;
+        case GameObjectType::PinkJumpPad: out = amm::HitKind::PinkPad; return true;
+        case GameObjectType::RedJumpPad: out = amm::HitKind::RedPad; return true;
+        case GameObjectType::GravityPad: out = amm::HitKind::BluePad; return true;
+        case GameObjectType::YellowJumpRing: out = amm::HitKind::YellowOrb; return true;
+        case GameObjectType::PinkJumpRing: out = amm::HitKind::PinkOrb; return true;
+        case GameObjectType::RedJumpRing: out = amm::HitKind::RedOrb; return true;
+        case GameObjectType::GravityRing: out = amm::HitKind::BlueOrb; return true;
+        case GameObjectType::GreenRing: out = amm::HitKind::GreenOrb; return true;
+        case GameObjectType::DropRing: out = amm::HitKind::BlackOrb; return true;
+        default: return false;
+    }
+}
+
+static bool portalGamemode(int objectID, amm::Gamemode& out) {
+    switch (objectID) {
+        case 12: out = amm::Gamemode::Cube; return true;
+        case 13: out = amm::Gamemode::Ship; return true;
+        case 47: out = amm::Gamemode::Ball; return true;
+        case 111: out = amm::Gamemode::Ufo; return true;
+        case 660: out = amm::Gamemode::Wave; return true;
+        case 745: out = amm::Gamemode::Robot; return true;
+        case 1331: out = amm::Gamemode::Spider; return true;
+        case 1933: out = amm::Gamemode::Swing; return true;
+        default: return false;
+    }
+}
+
+static bool portalSpeed(int objectID, float& out) {
+    switch (objectID) {
+        case 200: out = 251.16f; return true;
+        case 201: out = 311.58f; return true;
+        case 202: out = 387.42f; return true;
+        case 203: out = 468.0f; return true;
+        case 1334: out = 576.0f; return true;
+        default: return false;
+    }
+}
+
+// Height of the corridor a portal opens for the mode, 0 if the mode has no ceiling.
+static float corridorHeight(amm::Gamemode mode) {
+    switch (mode) {
+        case amm::Gamemode::Cube:
+        case amm::Gamemode::Robot: return 0.0f;
+        case amm::Gamemode::Ball:
+        case amm::Gamemode::Spider: return 240.0f;
+        default: return 300.0f;
+    }
+}
+
+// Adds the object's hitbox to the level and returns which shape it became.
+static amm::DynamicShape addShape(amm::LevelSnapshot& level, GameObject* obj, amm::HitKind kind) {
+    auto pos = obj->getPosition();
+    float scaleX = obj->getScaleX(), scaleY = obj->getScaleY();
+    float rotation = obj->getRotation();
+    // cocos rotation is clockwise in degrees
+    float c = std::cos(-rotation * DEG_TO_RAD);
+    float s = std::sin(-rotation * DEG_TO_RAD);
+
+    if (obj->m_objectRadius > 0.0f) {
+        level.circles.add(pos.x, pos.y, obj->m_objectRadius * std::max(scaleX, scaleY), kind);
+        return {amm::ShapeFamily::Circle, (uint32_t)level.circles.size() - 1, 0};
+    }
+
+    float hx = obj->m_width * 0.5f * scaleX, hy = obj->m_height * 0.5f * scaleY;
+
+    if (obj->m_objectType == GameObjectType::Slope) {
+        // Unrotated slope rises from bottom-left to top-right; flips mirror it.
+        float fx = obj->isFlipX() ? -1.0f : 1.0f, fy = obj->isFlipY() ? -1.0f : 1.0f;
+        float lx[3] = {-hx * fx, hx * fx, hx * fx};
+        float ly[3] = {-hy * fy, -hy * fy, hy * fy};
+        float wx[3], wy[3];
+        for (int i = 0; i < 3; ++i) {
+            wx[i] = pos.x + lx[i] * c - ly[i] * s;
+            wy[i] = pos.y + lx[i] * s + ly[i] * c;
+        }
+        level.triangles.add(wx[0], wy[0], wx[1], wy[1], wx[2], wy[2], kind);
+        return {amm::ShapeFamily::Triangle, (uint32_t)level.triangles.size() - 1, 0};
+    }
+
+    if (std::fmod(std::fabs(rotation), 90.0f) > 0.01f) {
+        level.orientedBoxes.add(pos.x, pos.y, hx, hy, c, s, kind);
+        return {amm::ShapeFamily::OrientedBox, (uint32_t)level.orientedBoxes.size() - 1, 0};
+    }
+
+    auto rect = obj->getObjectRect();
+    level.boxes.add(rect.getMinX(), rect.getMinY(), rect.getMaxX(), rect.getMaxY(), kind);
+    return {amm::ShapeFamily::Box, (uint32_t)level.boxes.size() - 1, 0};
+}
+
+static amm::TriggerKind triggerKind(int objectID) {
+    switch (objectID) {
+        case 901: return amm::TriggerKind::Move;
+        case 1346: return amm::TriggerKind::Rotate;
+        case 1347: return amm::TriggerKind::Follow;
+        case 1814: return amm::TriggerKind::FollowPlayerY;
+        case 1049: return amm::TriggerKind::Toggle;
+        case 1268: return amm::TriggerKind::Spawn;
+        case 2066: return amm::TriggerKind::Player; // gravity
+        default: return amm::TriggerKind::Decoration;
+    }
+}
+
+static std::vector<int> objectGroups(GameObject* obj) {
+    std::vector<int> groups;
+    if (!obj->m_groups) return groups;
+    for (int i = 0; i < obj->m_groupCount; ++i) groups.push_back((*obj->m_groups)[i]);
+    return groups;
+}
+
+static bool inAnyGroup(GameObject* obj, const std::unordered_set<int>& groups) {
+    for (int g : objectGroups(obj))
+        if (groups.count(g)) return true;
+    return false;
+}
+
+static amm::ObjectPose objectPose(GameObject* obj) {
+    return {obj->getPositionX(), obj->getPositionY(), obj->getRotation(), !obj->m_isGroupDisabled};
+}
+
+// Engine side of a cached level (LevelCache.hpp): the current PlayLayer's objects behind
+// CompiledLevel::compiledPose.
+struct BoundLevel {
+    PlayLayer* layer = nullptr;
+    uint64_t key = 0; // levelKey(), also the solution cache key
+    std::shared_ptr<amm::CachedLevel> cached;
+    std::vector<GameObject*> dynamicObjects;
+};
+
+// Key of a level in the level cache: a hash of its level data and object count, so the
+// same level loaded again finds its entry and an edited one does not. Main thread only.
+static uint64_t levelKey(PlayLayer* pl, size_t objectCount) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](const void* data, size_t size) {
+        auto p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+    };
+    if (pl->m_level) {
+        std::string data = pl->m_level->m_levelString;
+        mix(data.data(), data.size());
+    }
+    mix(&objectCount, sizeof(objectCount));
+    return h;
+}
+
+// Objects that change the player in ways the solver's physics does not model, or null.
+// Gravity triggers are noted after slicing (see compileLevel), since only the ones that
+// run matter.
+static const char* unsupportedKind(int objectID) {
+    switch (objectID) {
+        case 101: return "mini portal";
+        case 286: return "dual portal";
+        case 747: return "teleport portal";
+        case 1704:
+        case 1751: return "dash orb";
+        case 3004: return "spider orb";
+        case 3005: return "spider pad";
+        case 3027: return "teleport orb";
+        default: return nullptr;
+    }
+}
+
+// `obj` as an unsupported object, with its hitbox as the box the player has to touch.
+static amm::UnsupportedObject unsupportedObject(GameObject* obj, const char* what) {
+    auto rect = obj->getObjectRect();
+    amm::UnsupportedObject u;
+    u.x = obj->getPositionX();
+    u.y = obj->getPositionY();
+    u.halfWidth = rect.size.width * 0.5f;
+    u.halfHeight = rect.size.height * 0.5f;
+    u.what = what;
+    return u;
+}
+
+// Copies the level geometry and portals into an engine-free compiled level, noting
+// which shapes belong to groups that gameplay-relevant triggers move or toggle (see
+// TriggerSlice.hpp). Must run on the main thread.
+static std::shared_ptr<amm::CompiledLevel> compileLevel(PlayLayer* pl) {
+    auto compiled = std::make_shared<amm::CompiledLevel>();
+    amm::LevelSnapshot& level = compiled->level;
+    level.endX = pl->m_levelLength;
+
+    // Slice the trigger graph down to what can affect gameplay objects.
+    std::vector<amm::TriggerInfo> triggers;
+    std::vector<EffectGameObject*> triggerObjects; // parallel to triggers
+    std::unordered_set<int> gameplayGroups;
+    for (auto obj : CCArrayExt<GameObject*>(pl->m_objects)) {
+        amm::HitKind kind;
+        amm::Gamemode mode;
+        float speed;
+        int id = obj->m_objectID;
+        if (const char* what = unsupportedKind(id)) compiled->unsupported.push_back(unsupportedObject(obj, what));
+        if (hitKindFor(obj, kind) || portalGamemode(id, mode) || portalSpeed(id, speed) || id == 10 || id == 11) {
+            for (int g : objectGroups(obj)) gameplayGroups.insert(g);
+        } else if (auto trigger = typeinfo_cast<EffectGameObject*>(obj)) {
+            amm::TriggerInfo& t = triggers.emplace_back();
+            t.kind = triggerKind(id);
+            t.target = trigger->m_targetGroupID;
+            if (t.kind == amm::TriggerKind::Rotate || t.kind == amm::TriggerKind::Follow)
+                t.source = trigger->m_centerGroupID;
+            t.groups = objectGroups(obj);
+            t.spawned = trigger->m_isSpawnTriggered;
+            triggerObjects.push_back(trigger);
+        }
+    }
+    amm::TriggerSlice slice = amm::sliceTriggers(triggers, gameplayGroups);
+    std::unordered_set<int> dynamicGroups = slice.moved;
+    dynamicGroups.insert(slice.toggled.begin(), slice.toggled.end());
+    compiled->triggersKept = slice.kept.size();
+    compiled->triggersDropped = slice.dropped;
+    // Kept player triggers run; the physics clone does not model them. One that fires
+    // on touch matters only where its box is, one that fires by X at every height.
+    for (uint32_t i : slice.kept) {
+        if (triggers[i].kind != amm::TriggerKind::Player) continue;
+        EffectGameObject* trigger = triggerObjects[i];
+        amm::UnsupportedObject u = unsupportedObject(trigger, "gravity trigger");
+        if (!trigger->m_isTouchTriggered) u.halfWidth = 0.0f, u.halfHeight = std::numeric_limits<float>::infinity();
+        compiled->unsupported.push_back(u);
+    }
+
+    struct Portal { float x, y; int id; };
+    std::vector<Portal> portals;
+
+    for (auto obj : CCArrayExt<GameObject*>(pl->m_objects)) {
+        uint32_t objectIndex = (uint32_t)compiled->objectCount++;
+        int id = obj->m_objectID;
+        amm::Gamemode mode;
+        float speed;
+        if (portalGamemode(id, mode) || portalSpeed(id, speed) || id == 10 || id == 11) {
+            portals.push_back({obj->getPositionX(), obj->getPositionY(), id});
+            continue;
+        }
+        amm::HitKind kind;
+        if (!hitKindFor(obj, kind)) continue;
+        amm::DynamicShape shape = addShape(level, obj, kind);
+        if (!dynamicGroups.empty() && inAnyGroup(obj, dynamicGroups)) {
+            shape.object = (uint32_t)compiled->objectIndex.size();
+            compiled->objectIndex.push_back(objectIndex);
+            compiled->compiledPose.push_back(objectPose(obj));
+            compiled->dynamic.push_back(shape);
+        }
+    }
+
+    // Walk the portals in X order building one section per portal; rebase() drops the
+    // ones the player has already passed.
+    std::sort(portals.begin(), portals.end(), [](const Portal& a, const Portal& b) { return a.x < b.x; });
+    amm::Section current;
+    current.startX = -1.0e9f;
+    level.sections.push_back(current);
+    for (const auto& p : portals) {
+        current.startX = p.x;
+        current.setGravity = -1;
+        if (portalGamemode(p.id, current.mode)) {
+            float height = corridorHeight(current.mode);
+            if (height > 0.0f) {
+                current.floorY = std::max(90.0f, std::floor((p.y - height * 0.5f) / 30.0f) * 30.0f);
+                current.ceilY = current.floorY + height;
+            } else {
+                current.floorY = 90.0f;
+                current.ceilY = 1.0e6f;
+            }
+        } else if (!portalSpeed(p.id, current.speed)) {
+            current.setGravity = p.id == 11 ? 1 : 0;
+        }
+        level.sections.push_back(current);
+    }
+
+    std::sort(compiled->unsupported.begin(), compiled->unsupported.end(),
+        [](const amm::UnsupportedObject& a, const amm::UnsupportedObject& b) { return a.x < b.x; });
+
+    amm::BoxMergeStats merge = amm::mergeStaticBoxes(*compiled);
+    compiled->boxesMerged = merge.before - merge.after;
+    return compiled;
+}
+
+// Finds the engine objects behind a compiled level's dynamic shapes in `pl`, which holds
+// the same level data. Main thread only.
+static std::vector<GameObject*> bindObjects(PlayLayer* pl, const amm::CompiledLevel& compiled) {
+    std::vector<GameObject*> objects;
+    objects.reserve(compiled.objectIndex.size());
+    uint32_t i = 0;
+    for (auto obj : CCArrayExt<GameObject*>(pl->m_objects)) {
+        if (objects.size() == compiled.objectIndex.size()) break;
+        if (compiled.objectIndex[objects.size()] == i++) objects.push_back(obj);
+    }
+    return objects;
+}
+
+// Status label text while solving: the share of the predicted work done and an ETA at
+// the rate so far (TreeEstimate.hpp), or the time until the solver gives up if that
+// comes first.
+static std::string solveStatus(const amm::SolveProgress& progress, const amm::TreeEstimator& tree, double elapsed,
+                               double timeLeft) {
+    double done = (double)(progress.work + tree.searched());
+    double total = amm::predictWork(done, progress.fraction, tree.remaining());
+    if (total <= 0.0 || done <= 0.0 || elapsed <= 0.0) return "Solving...";
+    int percent = (int)std::floor(std::min(1.0, done / total) * 100.0);
+    double eta = elapsed * (total - done) / done;
+    if (eta > timeLeft) return fmt::format("Solving... {}% explored, gives up in {:.0f} s", percent, timeLeft);
+    return fmt::format("Solving... {}% explored, about {:.0f} s left", percent, eta);
+}
+
+// The player's state at pause time. Must run on the main thread.
+static amm::LiveStart liveStart(PlayLayer* pl) {
+    amm::LiveStart live;
+    auto player = pl->m_player1;
+    if (!player) return live;
+
+    live.x = player->getPositionX();
+    live.y = player->getPositionY();
+    live.vy = (float)player->m_yVelocity * 60.0f;
+    live.flipped = player->m_isUpsideDown;
+    live.known = true;
+    if (player->m_isShip) live.mode = amm::Gamemode::Ship;
+    else if (player->m_isBall) live.mode = amm::Gamemode::Ball;
+    else if (player->m_isBird) live.mode = amm::Gamemode::Ufo;
+    else if (player->m_isDart) live.mode = amm::Gamemode::Wave;
+    else if (player->m_isRobot) live.mode = amm::Gamemode::Robot;
+    else if (player->m_isSpider) live.mode = amm::Gamemode::Spider;
+    else if (player->m_isSwing) live.mode = amm::Gamemode::Swing;
+    else live.mode = amm::Gamemode::Cube;
+
+    float ps = player->m_playerSpeed;
+    live.speed = ps < 0.8f ? 251.16f : ps < 1.0f ? 311.58f : ps < 1.2f ? 387.42f : ps < 1.4f ? 468.0f : 576.0f;
+    return live;
+}
+
 // Forward declaration of helper to schedule on main (Cocos) thread
 static void runOnMainThread(std::function<void()> fn) {
     // Use Cocos Director scheduler to schedule on the main GL thread.
@@ -56,12 +428,63 @@ public:
 
     void onLoad() override {
         log::info("AutomaticMacroMaker loaded (entity12208)");
+        m_profiler.setHitchThreshold((double)Mod::get()->getSettingValue<int64_t>("hitch-threshold-ms"));
+        m_profiler.setHitchHandler([](const std::string& site, double ms) {
+            log::warn("AutomaticMacroMaker: hitch: {} took {:.1f} ms on the main thread", site, ms);
+        });
+
+        // Solutions persist across sessions (SolutionCache.hpp); with idle pre-solving on,
+        // levels left behind are solved into it while the player is in the menus.
+        if (!m_solutions.open(Mod::get()->getSaveDir() / "solutions"))
+            log::warn("AutomaticMacroMaker: could not open the solution cache");
+        if (m_solutions.isOpen() && Mod::get()->getSettingValue<bool>("idle-presolve")) {
+            amm::IdleSolver::Settings idle;
+            idle.strategy = Mod::get()->getSettingValue<std::string>("solver-strategy");
+            idle.robust = Mod::get()->getSettingValue<bool>("multi-rate-robust");
+            idle.scan = Mod::get()->getSettingValue<bool>("feasibility-scan");
+            idle.timeoutMs = IDLE_TIMEOUT_MS;
+            idle.dt = SIM_DT;
+            m_idle = std::make_unique<amm::IdleSolver>(m_solutions, idle,
+                [](uint64_t key, bool solved, const std::string& report) {
+                    log::info("AutomaticMacroMaker: idle pre-solve of level {:016x} {} ({})", key,
+                        solved ? "succeeded" : "failed", report);
+                });
+            // Newest last, since every add() goes to the front of the queue.
+            std::vector<uint64_t> retry = m_solutions.unsolved(IDLE_RETRY_LEVELS);
+            for (auto it = retry.rbegin(); it != retry.rend(); ++it) {
+                amm::CorpusEntry entry;
+                if (m_solutions.load(*it, entry)) m_idle->add(*it, std::move(entry.level));
+            }
+            log::info("AutomaticMacroMaker: idle pre-solving on, {} failed levels queued again", retry.size());
+        }
         // Nothing else required here; $modify(PlayLayer) will handle UI injection.
     }
 
+    // A level started: record where, and keep the idle solver off the CPU while it is played.
+    void onLevelStart(PlayLayer* pl) {
+        m_levelStart = liveStart(pl);
+        if (m_idle) m_idle->pause();
+    }
+
+    // The player leaves `pl`: queue its level for the idle solver from where it started,
+    // unless the solution cache already has it, and let the idle solver run again. Only
+    // a level a press has compiled and bound is queued; compiling reads the engine
+    // objects, so it cannot move off this thread, and the rebase runs on the idle one.
+    void onLevelExit(PlayLayer* pl) {
+        if (!m_idle) return;
+        amm::MainThreadProfiler::Scope timing(m_profiler, "idle queue");
+        size_t objectCount = pl->m_objects ? pl->m_objects->count() : 0;
+        if (m_levelStart.known && m_bound.layer == pl && m_bound.cached &&
+            m_bound.cached->compiled->objectCount == objectCount && !m_solutions.contains(m_bound.key))
+            m_idle->add(m_bound.key, m_bound.cached->compiled, m_levelStart);
+        m_levelStart = {};
+        m_idle->resume();
+    }
+
     // Called from PlayLayer modification when user presses the M button
     void onRequestMacro(PlayLayer* pl) {
         if (!pl) return;
+        amm::MainThreadProfiler::Scope timing(m_profiler, "snapshot");
 
         // All engine calls here must be on main thread. We're already on the main thread
         // because the button callback is performed on the main thread by Cocos.
@@ -82,91 +505,226 @@ public:
             log::warn("AutomaticMacroMaker: takeStateSnapshot not available; continuing without snapshot");
         }
 
-        // Prepare a minimal copy of state needed by the solver.
-        // For a robust solver you'd copy many objects: positions, velocities, object types, etc.
-        // Here we copy only a small snapshot placeholder; you can extend this with actual level data copies.
-        struct SolverInput {
-            float playerX = 0.0f;
-            float playerY = 0.0f;
-            // add more fields if you want a richer simulation copy
-        } solverInput;
-
-        if (pl->m_player1) {
-            solverInput.playerX = pl->m_player1->getPositionX();
-            solverInput.playerY = pl->m_player1->getPositionY();
+        // Copy everything the solver needs into an engine-free snapshot. The job is shared
+        // with the background thread so nothing it touches lives on this stack frame.
+        struct SolveJob {
+            amm::LevelSnapshot level;
+            std::shared_ptr<const amm::Broadphase> broadphase; // null until built, unless shared
+            std::shared_ptr<amm::CachedLevel> cached;          // set while borrowing its broadphase and sections
+            std::shared_ptr<amm::SectionCache> sections;
+            amm::HazardRaster raster;
+            amm::ValueModel model;                          // untrained unless a weights file exists
+            std::filesystem::path modelFile;
+            amm::TreeEstimator estimator;                   // tick search tree size, for the status label
+            std::filesystem::path corpusFile;               // empty unless corpus dumps are on
+            std::vector<amm::UnsupportedObject> unsupported; // of the compiled level, for the feasibility scan
+            std::string failure;                            // why the level cannot be finished, if the scan knows
+            uint64_t key = 0;                               // in the solution cache
+            std::vector<std::vector<FrameInput>> sequences; // best first, the rest are fallbacks
+        };
+        auto job = std::make_shared<SolveJob>();
+
+        // Compiled levels are cached for the session (LevelCache.hpp), across presses and
+        // across PlayLayers of the same level; only the player and the shapes of
+        // trigger-moved groups are read again.
+        auto prepareStart = Clock::now();
+        const char* source = bindLevel(pl);
+        job->key = m_bound.key;
+        const amm::CompiledLevel& compiled = *m_bound.cached->compiled;
+        std::vector<amm::ObjectPose> livePose;
+        livePose.reserve(m_bound.dynamicObjects.size());
+        for (auto obj : m_bound.dynamicObjects) livePose.push_back(objectPose(obj));
+        amm::RebaseStats rebaseStats;
+        job->level = amm::rebase(compiled, livePose, liveStart(pl), &rebaseStats);
+        // Unmoved shapes rebase to the compiled ones, so the broadphase and the solved
+        // sections of earlier solves still hold. Sections are lent to one solve at a time.
+        if (rebaseStats.moved == 0 && rebaseStats.disabled == 0) {
+            job->cached = m_bound.cached;
+            job->broadphase = job->cached->broadphase;
+            job->sections = std::move(job->cached->sections);
+        }
+        log::info("AutomaticMacroMaker: {} level in {} ms ({} boxes merged away, {} of {} triggers affect gameplay, "
+            "{} trigger-driven shapes, {} moved, {} turned, {} switched off)",
+            source, std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - prepareStart).count(),
+            compiled.boxesMerged, compiled.triggersKept, compiled.triggersKept + compiled.triggersDropped,
+            compiled.dynamic.size(), rebaseStats.moved, rebaseStats.rotated, rebaseStats.disabled);
+        log::info("AutomaticMacroMaker: level cache: {} levels, {} KB, {} hits, {} misses, {} evicted{}",
+            m_levels.size(), m_levels.bytes() >> 10, m_levels.hits(), m_levels.misses(), m_levels.evictions(),
+            job->cached ? (job->broadphase ? "; reusing broadphase" : "; sharing this solve's broadphase") : "");
+        job->unsupported = compiled.unsupported;
+        job->modelFile = Mod::get()->getSaveDir() / "value-model.txt";
+        if (Mod::get()->getSettingValue<bool>("dump-corpus")) {
+            std::string name = pl->m_level ? std::string(pl->m_level->m_levelName) : "level";
+            for (auto& c : name) if (!std::isalnum((unsigned char)c)) c = '_';
+            auto dir = Mod::get()->getSaveDir() / "corpus";
+            std::filesystem::create_directories(dir);
+            job->corpusFile = dir / fmt::format("{}_{}{}", name, (int)std::time(nullptr), amm::CORPUS_EXTENSION);
         }
+        std::string strategyName = Mod::get()->getSettingValue<std::string>("solver-strategy");
+        bool robust = Mod::get()->getSettingValue<bool>("multi-rate-robust");
+        size_t wanted = (size_t)std::max<int64_t>(1, Mod::get()->getSettingValue<int64_t>("diverse-solutions"));
+        size_t bitStateMb = (size_t)std::max<int64_t>(0, Mod::get()->getSettingValue<int64_t>("bitstate-mb"));
+        bool checkFeasible = Mod::get()->getSettingValue<bool>("feasibility-scan");
+        log::info("AutomaticMacroMaker: snapshot has {} shapes, {} sections; collision kernels: {}",
+            job->level.shapeCount(), job->level.sections.size(), amm::collisionKernels().name);
 
         // Launch background solver thread (pure computation)
-        std::atomic<bool> solverFound(false);
-        std::vector<FrameInput> foundSequence;
-        std::thread solverThread([this, &solverFound, &foundSequence, solverInput, pl]() mutable {
+        std::thread solverThread([this, job, pl, strategyName, robust, wanted, bitStateMb, checkFeasible]() {
             // Background thread: pure compute. NO engine/PlayLayer calls allowed.
             auto start = Clock::now();
+            const amm::LevelSnapshot& level = job->level;
+            amm::ValueGuide guide;
+            // Lossy bit-state visited set for the tick search, shared by every section.
+            std::unique_ptr<amm::BitStateSet> bitState;
 
-            // Simple iterative deepening DFS with timeout
-            std::vector<FrameInput> seq;
-            seq.reserve(10000);
-
-            std::function<bool(int)> dfs;
-            dfs = [&](int frame) -> bool {
-                auto now = Clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
-                if (elapsed > SOLVER_TIMEOUT_MS) return false;
-                if (frame >= MAX_SEARCH_FRAMES) return false;
-
-                // For the prototype, we will use a VERY conservative termination check:
-                // after N frames where player X progressed beyond some threshold, consider success.
-                // Real solver should check collisions using an engine-free physics clone.
-                const int SUCCESS_X_THRESHOLD = 5000; // placeholder: large number indicating end of level
-                if ((frame > 0) && (frame * 10 > SUCCESS_X_THRESHOLD)) {
-                    foundSequence = seq;
-                    return true;
+            // Preparation stages, in parallel where their dependencies allow (TaskGraph.hpp).
+            amm::TaskGraph prepare;
+            std::vector<amm::TaskGraph::Task> needBroadphase;
+            if (!job->broadphase) {
+                needBroadphase.push_back(prepare.add("broadphase", [&]() {
+                    auto broadphase = std::make_shared<amm::Broadphase>();
+                    broadphase->build(level);
+                    job->broadphase = std::move(broadphase);
+                }));
+            }
+            // Levels that provably cannot be finished fail here instead of at the timeout,
+            // unless the player turned the scan off.
+            amm::Feasibility scan;
+            if (checkFeasible) {
+                prepare.add("feasibility scan", [&]() {
+                    scan = amm::scanFeasibility(level, *job->broadphase, SIM_DT, job->unsupported);
+                }, needBroadphase);
+            }
+            auto model = prepare.add("value model", [&]() {
+                if (job->model.load(job->modelFile)) log::info("AutomaticMacroMaker: using trained value model");
+            });
+            prepare.add("hazard raster", [&]() {
+                if (!job->model.trained()) return;
+                job->raster.build(level);
+                guide = {&level, &job->model, &job->raster};
+            }, {model});
+            if (bitStateMb > 0) {
+                prepare.add("bit-state set", [&]() {
+                    bitState = std::make_unique<amm::BitStateSet>(bitStateMb * 8 * 1024 * 1024);
+                });
+            }
+            prepare.run();
+            log::info("AutomaticMacroMaker: prepared {}", prepare.report());
+            // A solution found before, by an earlier press or the idle solver, is used if
+            // what is left of it still finishes the level from here.
+            amm::CorpusEntry known;
+            bool haveKnown = m_solutions.load(job->key, known);
+            if (haveKnown) {
+                amm::Timeline resumed = amm::resumeSolution(known, level, *job->broadphase, SIM_DT);
+                if (!resumed.empty()) {
+                    log::info("AutomaticMacroMaker: using the cached solution from x {:.0f}, {} ticks, checked in {} ms",
+                        level.startX, resumed.size(),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+                    auto& sequence = job->sequences.emplace_back();
+                    for (uint8_t hold : resumed) sequence.push_back({hold != 0});
+                    runOnMainThread([this, job, pl]() {
+                        this->returnCachedLevel(*job);
+                        this->onSolverFinished(pl, job->sequences, job->failure);
+                    });
+                    return;
                 }
+            }
+            if (!scan.feasible) {
+                job->failure = fmt::format("{} at x {:.0f}", scan.reason, scan.x);
+                log::info("AutomaticMacroMaker: not solving, {} ({} ticks scanned)", job->failure, scan.ticks);
+                runOnMainThread([this, job, pl]() {
+                    this->returnCachedLevel(*job);
+                    this->onSolverFinished(pl, job->sequences, job->failure);
+                });
+                return;
+            }
 
-                // Branch 1: no click this frame
-                seq.push_back({false});
-                if (dfs(frame + 1)) return true;
-                seq.pop_back();
-
-                // Branch 2: click this frame
-                seq.push_back({true});
-                if (dfs(frame + 1)) return true;
-                seq.pop_back();
+            amm::SolveContext ctx;
+            ctx.level = &level;
+            ctx.broadphase = job->broadphase.get();
+            ctx.settings.dt = SIM_DT;
+            ctx.settings.maxTicks = MAX_SEARCH_FRAMES;
+            ctx.settings.robust = robust;
+            ctx.settings.solutions = wanted;
+            ctx.settings.guide = &guide;
+            ctx.settings.bitState = bitState.get();
+            ctx.settings.sectionCache = job->sections.get();
+            ctx.settings.estimator = &job->estimator;
+            ctx.deadline.at = start + std::chrono::milliseconds(SOLVER_TIMEOUT_MS);
 
-                return false;
+            std::unique_ptr<amm::SolverStrategy> strategy = amm::createStrategy(strategyName);
+            if (!strategy) {
+                log::warn("AutomaticMacroMaker: unknown solver strategy '{}', using '{}'", strategyName,
+                    amm::strategies().front().name);
+                strategy = amm::strategies().front().create();
+            }
+            strategy->prepare(ctx);
+            // Progress goes to the status label at most every STATUS_INTERVAL_MS, between
+            // steps and from inside long tick searches.
+            auto lastStatus = start;
+            auto postStatus = [&]() {
+                auto now = Clock::now();
+                if (now - lastStatus < std::chrono::milliseconds(STATUS_INTERVAL_MS)) return;
+                lastStatus = now;
+                std::string text = solveStatus(strategy->progress(), job->estimator,
+                    std::chrono::duration<double>(now - start).count(),
+                    std::chrono::duration<double>(ctx.deadline.at - now).count());
+                runOnMainThread([this, text]() { this->setStatus(text); });
             };
+            job->estimator.setListener(postStatus);
+            while (strategy->step(STEP_BUDGET)) postStatus();
+            job->estimator.setListener({});
+            std::vector<amm::Timeline> solutions = strategy->extract();
 
-            bool ok = dfs(0);
-            if (ok) {
-                solverFound = true;
-            } else {
-                solverFound = false;
+            for (const auto& solution : solutions) {
+                auto& sequence = job->sequences.emplace_back();
+                sequence.reserve(solution.size());
+                for (uint8_t hold : solution) sequence.push_back({hold != 0});
             }
+            if (!job->corpusFile.empty()) {
+                amm::CorpusEntry entry;
+                entry.level = level;
+                entry.solved = !solutions.empty();
+                if (entry.solved) entry.solution = solutions.front();
+                if (!amm::saveCorpusEntry(entry, job->corpusFile))
+                    log::warn("AutomaticMacroMaker: could not write corpus entry {}", job->corpusFile.string());
+            }
+            // The cache keeps the solution that covers the most of the level.
+            if (!solutions.empty()) {
+                amm::CorpusEntry entry;
+                entry.level = level;
+                entry.solved = true;
+                entry.solution = solutions.front();
+                if (!m_solutions.offer(job->key, entry))
+                    log::warn("AutomaticMacroMaker: could not write the solution cache entry");
+            }
+            log::info("AutomaticMacroMaker: {} solver {} after {} ms ({})", strategyName,
+                job->sequences.empty() ? "failed" : "succeeded",
+                std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count(),
+                strategy->report());
+            if (bitState)
+                log::info("AutomaticMacroMaker: bit-state visited set {} MB, {:.1f}% full",
+                    bitState->bytes() >> 20, bitState->fill() * 100.0);
+            const amm::CollisionMemo& memo = job->broadphase->memo();
+            log::info("AutomaticMacroMaker: collision memo {:.1f}% hits over {} lookups, {} cells, {} KB",
+                memo.lookups() ? 100.0 * (double)memo.hits() / (double)memo.lookups() : 0.0, memo.lookups(),
+                memo.cells(), memo.bytes() >> 10);
 
             // When solver finishes (found or not), schedule to main thread to finalize and attempt recording.
-            runOnMainThread([this, &solverFound, &foundSequence, pl]() {
-                this->onSolverFinished(pl, solverFound ? &foundSequence : nullptr);
+            runOnMainThread([this, job, pl]() {
+                this->returnCachedLevel(*job);
+                this->onSolverFinished(pl, job->sequences, job->failure);
             });
         });
 
         solverThread.detach();
     }
 
-    // Called on main thread after solver finishes; safe to call engine APIs here.
-    void onSolverFinished(PlayLayer* pl, std::vector<FrameInput>* sequence) {
-        if (!pl) return;
-
-        if (!sequence || sequence->empty()) {
-            // No sequence found
-            // Restore snapshot and unpause
-            try { pl->restoreStateSnapshot(); } catch(...) {}
-            pl->pauseGame(false);
-            log::info("AutomaticMacroMaker: solver did not find a sequence or sequence empty.");
-            if (m_modalStatusLabel) m_modalStatusLabel->setString("No solution found.");
-            return;
-        }
-
-        // We have a candidate sequence. Use engine recording APIs to play the sequence and record a replay.
+    // Plays one sequence through the engine while recording. Returns the recorded replay,
+    // or an empty string if recording is unavailable or the player died on the way.
+    // Main thread only.
+    std::string recordSequence(PlayLayer* pl, const std::vector<FrameInput>& sequence) {
+        amm::MainThreadProfiler::Scope timing(m_profiler, "replay");
         // NOTE: exact APIs (startRecording/stopRecording/getRecordedReplay) exist in many Geode versions.
         // If method names differ, adjust according to your Geode binding headers.
 
@@ -178,8 +736,8 @@ public:
         }
 
         // Simulate the sequence by stepping the engine frame-by-frame and injecting input.
-        for (size_t i = 0; i < sequence->size(); ++i) {
-            const FrameInput &f = (*sequence)[i];
+        for (size_t i = 0; i < sequence.size(); ++i) {
+            const FrameInput &f = sequence[i];
 
             if (f.click) {
                 if (pl->m_player1) {
@@ -199,6 +757,8 @@ public:
             } catch (...) {
                 // If update isn't accessible, this may be implemented differently in your environment.
             }
+
+            if (pl->m_player1 && pl->m_player1->m_isDead) break;
         }
 
         // Stop recording and retrieve replay bytes/string
@@ -208,6 +768,8 @@ public:
             log::warn("AutomaticMacroMaker: stopRecording failed or not available.");
         }
 
+        if (pl->m_player1 && pl->m_player1->m_isDead) return "";
+
         // Attempt to read recorded replay data from PlayLayer. Many versions store it in a field or provide a getter.
         std::string replayData;
         try {
@@ -219,10 +781,91 @@ public:
             replayData = "";
             log::warn("AutomaticMacroMaker: unable to access pl->m_replay; replay export may fail.");
         }
+        return replayData;
+    }
+
+    // Called on main thread after solver finishes; safe to call engine APIs here.
+    // `sequences` holds the solutions best first; each one that fails in the engine is
+    // replaced by the next without searching again. `failure` says why there is no
+    // sequence when the feasibility scan knows.
+    void onSolverFinished(PlayLayer* pl, const std::vector<std::vector<FrameInput>>& sequences,
+                          const std::string& failure = {}) {
+        if (!pl) return;
+        finishSolve(pl, sequences, failure);
+        log::info("AutomaticMacroMaker: main thread: {}", m_profiler.summary());
+    }
+
+    // UI helpers to manage modal status label pointer
+    void setModalStatusLabel(cocos2d::CCLabelBMFont* lbl) { m_modalStatusLabel = lbl; }
+
+    void setStatus(const std::string& text) {
+        amm::MainThreadProfiler::Scope timing(m_profiler, "status");
+        if (m_modalStatusLabel) m_modalStatusLabel->setString(text.c_str());
+    }
+
+    amm::MainThreadProfiler& profiler() { return m_profiler; }
+
+    // The bound level holds engine object pointers; drop them before the PlayLayer goes
+    // away. The compiled level stays in the level cache.
+    void unbindLevel() { m_bound = {}; }
+
+private:
+    // Points m_bound at the compiled level of `pl`, compiling it unless the level cache
+    // has it. Returns where the level came from, for the log. Main thread only.
+    const char* bindLevel(PlayLayer* pl) {
+        m_levels.setBudget((size_t)std::max<int64_t>(0, Mod::get()->getSettingValue<int64_t>("level-cache-mb")) << 20);
+        size_t objectCount = pl->m_objects ? pl->m_objects->count() : 0;
+        if (m_bound.layer == pl && m_bound.cached && m_bound.cached->compiled->objectCount == objectCount)
+            return "rebased cached";
+        const char* source = "rebased session-cached";
+        uint64_t key = levelKey(pl, objectCount);
+        auto cached = m_levels.find(key);
+        if (!cached || cached->compiled->objectCount != objectCount) {
+            cached = std::make_shared<amm::CachedLevel>();
+            cached->compiled = compileLevel(pl);
+            m_levels.insert(key, cached);
+            source = "compiled";
+        }
+        m_bound = {pl, key, cached, bindObjects(pl, *cached->compiled)};
+        return source;
+    }
+
+    // Hands what a solve borrowed from its cached level back, with the broadphase it
+    // built, and trims the cache now that the entry may have grown. Main thread only.
+    template <class Job> void returnCachedLevel(Job& job) {
+        if (!job.cached) return;
+        if (!job.cached->broadphase) job.cached->broadphase = std::move(job.broadphase);
+        if (!job.cached->sections) job.cached->sections = std::move(job.sections);
+        job.cached.reset();
+        m_levels.trim();
+    }
+
+    void finishSolve(PlayLayer* pl, const std::vector<std::vector<FrameInput>>& sequences, const std::string& failure) {
+        amm::MainThreadProfiler::Scope timing(m_profiler, "finish");
+
+        if (sequences.empty() || sequences.front().empty()) {
+            // No sequence found
+            // Restore snapshot and unpause
+            try { pl->restoreStateSnapshot(); } catch(...) {}
+            pl->pauseGame(false);
+            log::info("AutomaticMacroMaker: solver did not find a sequence or sequence empty.");
+            setStatus(failure.empty() ? "No solution found." : "No solution: " + failure + ".");
+            return;
+        }
+
+        // We have candidate sequences. Use engine recording APIs to play them and record a replay.
+        std::string replayData;
+        for (size_t i = 0; i < sequences.size() && replayData.empty(); ++i) {
+            if (i > 0) {
+                log::info("AutomaticMacroMaker: solution {} failed in the engine, trying fallback {}", i, i + 1);
+                try { pl->restoreStateSnapshot(); } catch(...) {}
+            }
+            replayData = recordSequence(pl, sequences[i]);
+        }
 
         if (replayData.empty()) {
             // best-effort: inform user and restore snapshot
-            if (m_modalStatusLabel) m_modalStatusLabel->setString("Solved but export failed (no replay).");
+            setStatus("Solved but export failed (no replay).");
             try { pl->restoreStateSnapshot(); } catch(...) {}
             pl->pauseGame(false);
             return;
@@ -247,18 +890,20 @@ public:
         out.close();
 
         log::info("AutomaticMacroMaker: exported replay to {}", filename);
-        if (m_modalStatusLabel) m_modalStatusLabel->setString(fmt::format("Exported: {}", filename));
+        setStatus(fmt::format("Exported: {}", filename));
 
         // Restore actual gameplay snapshot and keep paused until user closes menu (per design)
         try { pl->restoreStateSnapshot(); } catch(...) {}
         // Note: we keep the game paused so the user can review/export again; they can close the menu to resume.
     }
 
-    // UI helpers to manage modal status label pointer
-    void setModalStatusLabel(cocos2d::CCLabelBMFont* lbl) { m_modalStatusLabel = lbl; }
-
-private:
     cocos2d::CCLabelBMFont* m_modalStatusLabel = nullptr;
+    BoundLevel m_bound;
+    amm::LevelCache m_levels;
+    amm::MainThreadProfiler m_profiler;
+    amm::LiveStart m_levelStart;               // of the level being played, for the idle solver
+    amm::SolutionCache m_solutions;
+    std::unique_ptr<amm::IdleSolver> m_idle;   // null unless idle pre-solving is on
 };
 
 // ---------- PlayLayer modification (file-scope $modify) ----------
@@ -266,12 +911,23 @@ class $modify(PlayLayer) {
     // Add a field to store our M button so we don't recreate it
     Field(CCMenuItem*, m_autoMacroButton, nullptr);
 
+    // leaving the level frees its objects, so the bound level must go first
+    void onQuit() {
+        auto mod = static_cast<AutomaticMacroMaker*>(AutomaticMacroMaker::get());
+        mod->onLevelExit(this);
+        mod->unbindLevel();
+        $orig();
+    }
+
     // call original onEnter
     void onEnter() {
         $orig();
+        amm::MainThreadProfiler::Scope timing(
+            static_cast<AutomaticMacroMaker*>(AutomaticMacroMaker::get())->profiler(), "onEnter");
 
         // create M button once
         if (!m_autoMacroButton) {
+            static_cast<AutomaticMacroMaker*>(AutomaticMacroMaker::get())->onLevelStart(this);
             auto winSize = CCDirector::get()->getWinSize();
 
             // Create a simple label-based button in case icon isn't present.
@@ -318,6 +974,7 @@ class $modify(PlayLayer) {
 
         // Access our mod singleton
         auto mod = static_cast<AutomaticMacroMaker*>(AutomaticMacroMaker::get());
+        amm::MainThreadProfiler::Scope timing(mod->profiler(), "onMacroButton");
 
         // If modal already exists, toggle it off
         if (m_modalLayer) {
@@ -0,0 +1,116 @@
+// tests/BoxMergeTest.cpp
+// AutomaticMacroMaker - merged boxes collide exactly like the blocks they replace
+// Developer: entity12208
+
+#include "BoxMerge.hpp"
+#include "Collision.hpp"
+#include "Physics.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace amm;
+
+// Old contacts mapped through `remap`, sorted and without repeats: what the merged
+// level must report for the same query.
+static std::vector<uint32_t> mapped(const std::vector<uint32_t>& boxes, const std::vector<uint32_t>& remap) {
+    std::vector<uint32_t> out;
+    for (uint32_t i : boxes) out.push_back(remap[i]);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+int main() {
+    LevelSnapshot level;
+    BoxSet& b = level.boxes;
+    // A floor of 30x30 solid blocks with a gap, a wall on top of it, and a 4x3 block of
+    // hazard tiles: all of these merge.
+    for (int i = 0; i < 100; ++i)
+        if (i < 40 || i > 44) b.add(30.0f * (float)i, 60.0f, 30.0f * (float)i + 30.0f, 90.0f, HitKind::Solid);
+    for (int i = 0; i < 4; ++i) b.add(900.0f + 30.0f * (float)i, 90.0f, 930.0f + 30.0f * (float)i, 120.0f, HitKind::Solid);
+    for (int i = 0; i < 12; ++i) {
+        float x = 1500.0f + 30.0f * (float)(i % 4), y = 90.0f + 30.0f * (float)(i / 4);
+        b.add(x, y, x + 30.0f, y + 30.0f, HitKind::Hazard);
+    }
+    // Same-kind boxes touching only at a corner, a solid next to a hazard, and a pad next
+    // to a thin solid on the floor (where the player touches two surfaces at once): none
+    // of these may merge.
+    size_t solidCorner = b.size();
+    b.add(2000.0f, 150.0f, 2030.0f, 180.0f, HitKind::Solid);
+    b.add(2030.0f, 180.0f, 2060.0f, 210.0f, HitKind::Solid);
+    size_t hazardCorner = b.size();
+    b.add(2200.0f, 150.0f, 2230.0f, 180.0f, HitKind::Hazard);
+    b.add(2230.0f, 120.0f, 2260.0f, 150.0f, HitKind::Hazard);
+    size_t mixed = b.size();
+    b.add(2400.0f, 90.0f, 2430.0f, 120.0f, HitKind::Solid);
+    b.add(2430.0f, 90.0f, 2460.0f, 120.0f, HitKind::Hazard);
+    size_t pad = b.size();
+    b.add(2600.0f, 90.0f, 2630.0f, 94.0f, HitKind::YellowPad);
+    b.add(2630.0f, 90.0f, 2660.0f, 94.0f, HitKind::Solid);
+    // Thin solids merge like any others.
+    b.add(2800.0f, 150.0f, 2830.0f, 160.0f, HitKind::Solid);
+    b.add(2830.0f, 150.0f, 2860.0f, 160.0f, HitKind::Solid);
+    level.sections.push_back({-1.0e30f, Gamemode::Cube, 311.58f, 0.0f, 1.0e6f, -1});
+    level.endX = 3000.0f;
+
+    LevelSnapshot merged = level;
+    BoxMergeStats stats;
+    std::vector<uint32_t> remap = mergeBoxes(merged.boxes, {}, &stats);
+    CHECK(stats.before == level.boxes.size());
+    // Floor in two runs, the wall, the hazard block, the eight boxes that stay and the
+    // thin pair.
+    CHECK(stats.after == 2 + 1 + 1 + 8 + 1);
+    for (size_t first : {solidCorner, hazardCorner, mixed, pad}) CHECK(remap[first] != remap[first + 1]);
+
+    Broadphase before, after;
+    before.build(level);
+    after.build(merged);
+
+    // Contacts of random boxes, and whole random moves, match once mapped.
+    const Gamemode modes[] = {Gamemode::Cube, Gamemode::Ship, Gamemode::Ball, Gamemode::Ufo,
+                              Gamemode::Wave, Gamemode::Robot, Gamemode::Spider, Gamemode::Swing};
+    ShapeList candidates, direct, contacts;
+    uint64_t rng = 99;
+    auto next = [&rng]() {
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        return rng >> 33;
+    };
+    size_t contactMismatches = 0, stepMismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        float x = (float)(next() % 300000) / 100.0f, y = 40.0f + (float)(next() % 20000) / 100.0f;
+        float half = 2.0f + (float)(next() % 1500) / 100.0f;
+        Aabb box{x - half, y - half, x + half, y + half};
+        findContacts(level, before, box, candidates, direct);
+        findContacts(merged, after, box, candidates, contacts);
+        std::sort(contacts.boxes.begin(), contacts.boxes.end());
+        if (mapped(direct.boxes, remap) != contacts.boxes) contactMismatches++;
+
+        PlayerState s;
+        s.x = x;
+        s.y = y;
+        s.vy = (float)(next() % 1600) - 800.0f;
+        s.mode = modes[next() % 8];
+        s.flipped = next() % 4 == 0;
+        s.onGround = next() % 2 == 0;
+        s.held = next() % 2 == 0;
+        PlayerState m = s;
+        for (int t = 0; t < 40; ++t) {
+            bool hold = next() % 3 == 0;
+            StepOutcome o1 = stepPlayer(level, before, s, hold, 1.0f / 240.0f);
+            StepOutcome o2 = stepPlayer(merged, after, m, hold, 1.0f / 240.0f);
+            uint32_t interact = s.lastInteract ? remap[s.lastInteract - 1] + 1 : 0;
+            if (o1 != o2 || s.x != m.x || s.y != m.y || s.vy != m.vy || s.onGround != m.onGround ||
+                s.flipped != m.flipped || interact != m.lastInteract) {
+                stepMismatches++;
+                break;
+            }
+            if (o1 != StepOutcome::Alive) break;
+        }
+    }
+    CHECK(contactMismatches == 0);
+    CHECK(stepMismatches == 0);
+
+    return test::testResult();
+}
@@ -0,0 +1,26 @@
+// tests/CollisionMemoTest.cpp
+// AutomaticMacroMaker - memoized player contacts match findContacts exactly
+// Developer: entity12208
+
+#include "Collision.hpp"
+#include "CollisionMemo.hpp"
+#include "TestUtil.hpp"
+
+using namespace amm;
+
+int main() {
+    LevelSnapshot level = test::contactLevel(200, 45.0f, 40);
+
+    Broadphase broadphase;
+    broadphase.build(level);
+    CHECK(test::memoMismatches(level, broadphase, 250.0f, 9500.0f, 200000) == 0);
+    CHECK(broadphase.memo().cells() > 0);
+
+    // A shape far from the rest puts the broadphase origin where a float step is much
+    // coarser than the slack around a cell; the memo must still answer exactly.
+    level.boxes.add(-1.0e9f, 0.0f, -1.0e9f + 30.0f, 30.0f, HitKind::Solid);
+    broadphase.build(level);
+    CHECK(test::memoMismatches(level, broadphase, 250.0f, 9500.0f, 200000) == 0);
+
+    return test::testResult();
+}
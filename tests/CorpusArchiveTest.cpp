@@ -0,0 +1,161 @@
+// tests/CorpusArchiveTest.cpp
+// AutomaticMacroMaker - the LZ codec and packed archives give back exactly what went in
+// Developer: entity12208
+
+#include "CorpusArchive.hpp"
+#include "Lz.hpp"
+#include "TestUtil.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace amm;
+
+static std::vector<uint8_t> randomBytes(size_t n, uint64_t seed) {
+    std::vector<uint8_t> v(n);
+    for (auto& b : v) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        b = (uint8_t)(seed >> 56);
+    }
+    return v;
+}
+
+// Compresses and decompresses `data`; false unless the bytes come back unchanged.
+static bool roundTrip(const std::vector<uint8_t>& data, size_t* packedSize = nullptr) {
+    std::vector<uint8_t> packed;
+    lzCompress(data.data(), data.size(), packed);
+    if (packedSize) *packedSize = packed.size();
+    std::vector<uint8_t> out(data.size());
+    return lzDecompress(packed.data(), packed.size(), out.data(), out.size()) && out == data;
+}
+
+static std::vector<uint8_t> encoded(const CorpusEntry& entry) {
+    std::vector<uint8_t> bytes;
+    encodeCorpusEntry(entry, bytes);
+    return bytes;
+}
+
+static void checkCodec() {
+    CHECK(roundTrip({}));
+    for (size_t n = 1; n <= 40; ++n) CHECK(roundTrip(randomBytes(n, n)));
+
+    // Incompressible: may grow a little, must still decode.
+    size_t packed = 0;
+    CHECK(roundTrip(randomBytes(200000, 7), &packed));
+    CHECK(packed < 200000 + 200000 / 100);
+
+    // Highly repetitive: one long run, a short period, and repeats further back than
+    // a 16-bit offset reaches.
+    CHECK(roundTrip(std::vector<uint8_t>(1 << 20, 0), &packed));
+    CHECK(packed < (1 << 20) / 100);
+    std::vector<uint8_t> period;
+    for (int i = 0; i < 100000; ++i) period.push_back((uint8_t)"abc"[i % 3]);
+    CHECK(roundTrip(period, &packed));
+    CHECK(packed < period.size() / 20);
+    std::vector<uint8_t> far = randomBytes(70000, 3);
+    far.insert(far.end(), far.begin(), far.begin() + 70000);
+    CHECK(roundTrip(far));
+
+    // Corrupt input fails instead of writing past the output.
+    std::vector<uint8_t> block;
+    lzCompress(period.data(), period.size(), block);
+    std::vector<uint8_t> out(period.size());
+    CHECK(!lzDecompress(block.data(), block.size() / 2, out.data(), out.size()));
+    out.resize(period.size() - 1);
+    CHECK(!lzDecompress(block.data(), block.size(), out.data(), out.size()));
+}
+
+static void checkArchive(const std::filesystem::path& dir) {
+    CorpusEntry repetitive;
+    repetitive.level = test::contactLevel(300, 30.0f, 40);
+    repetitive.solved = true;
+    repetitive.solution = Timeline(5000, 0);
+
+    CorpusEntry noisy;
+    noisy.level.sections.push_back({-1.0e30f, Gamemode::Ship, 311.58f, 90.0f, 390.0f, -1});
+    std::vector<uint8_t> r = randomBytes(4000 * 4, 11);
+    for (size_t i = 0; i + 4 <= r.size(); i += 4) {
+        float x = (float)(r[i] | r[i + 1] << 8) * 0.37f, y = 90.0f + (float)r[i + 2] * 1.13f;
+        noisy.level.boxes.add(x, y, x + 1.0f + (float)r[i + 3], y + 30.0f, (r[i + 3] & 1) ? HitKind::Hazard : HitKind::Solid);
+    }
+    noisy.level.endX = 25000.0f;
+
+    CorpusEntry empty;
+    empty.level.sections.push_back({});
+
+    std::filesystem::path path = dir / "corpus.ammp";
+    {
+        CorpusArchiveWriter writer;
+        CHECK(writer.open(path));
+        CHECK(writer.add("repetitive.amms", repetitive));
+        CHECK(writer.add("noisy.amms", noisy));
+        CHECK(writer.add("empty.amms", empty));
+        CHECK(writer.finish());
+        CHECK(writer.storedBytes() < writer.rawBytes());
+    }
+
+    CorpusArchive archive;
+    CHECK(archive.open(path));
+    CHECK(archive.size() == 3);
+    const std::pair<const char*, const CorpusEntry*> entries[] = {
+        {"repetitive.amms", &repetitive}, {"noisy.amms", &noisy}, {"empty.amms", &empty}};
+    for (const auto& [name, original] : entries) {
+        size_t i = archive.find(name);
+        CHECK(i < archive.size() && archive.name(i) == name);
+        if (i >= archive.size()) continue;
+        CorpusEntry loaded;
+        CHECK(archive.load(i, loaded));
+        CHECK(encoded(loaded) == encoded(*original));
+    }
+    CHECK(archive.find("missing.amms") == archive.size());
+
+    // A flipped byte inside an entry fails the content hash.
+    size_t victim = archive.find("repetitive.amms");
+    uint64_t offset = archive.entry(victim).offset + archive.entry(victim).storedSize / 2;
+    archive.close();
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekg((std::streamoff)offset);
+        char c = 0;
+        f.read(&c, 1);
+        f.seekp((std::streamoff)offset);
+        c = (char)(c ^ 0x5a);
+        f.write(&c, 1);
+    }
+    CHECK(archive.open(path));
+    CorpusEntry loaded;
+    CHECK(!archive.load(archive.find("repetitive.amms"), loaded));
+    archive.close();
+
+    // An archive of no entries is still a valid archive.
+    std::filesystem::path none = dir / "none.ammp";
+    {
+        CorpusArchiveWriter writer;
+        CHECK(writer.open(none) && writer.finish());
+    }
+    CHECK(archive.open(none) && archive.size() == 0 && archive.find("empty.amms") == 0);
+    archive.close();
+
+    // A writer dropped before finish() leaves no half-written archive behind.
+    std::filesystem::path partial = dir / "partial.ammp";
+    {
+        CorpusArchiveWriter writer;
+        CHECK(writer.open(partial));
+        CHECK(writer.add("empty.amms", empty));
+    }
+    CHECK(!std::filesystem::exists(partial));
+}
+
+int main() {
+    checkCodec();
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "amm-corpus-archive-test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    checkArchive(dir);
+    std::filesystem::remove_all(dir);
+
+    return test::testResult();
+}
@@ -0,0 +1,98 @@
+// tests/DeltaPlaneTest.cpp
+// AutomaticMacroMaker - delta-packed back pointers decode to exactly what was encoded
+// Developer: entity12208
+
+#include "DeltaPlane.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace amm;
+
+static uint64_t rng = 4242;
+
+static uint32_t next() {
+    rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+    return (uint32_t)(rng >> 33);
+}
+
+// Encodes `values` and reads them back through at() and decodeBlock(); false on any
+// difference.
+static bool roundTrip(const std::vector<uint16_t>& values) {
+    DeltaPlane plane(values);
+    if (plane.size() != values.size()) return false;
+    for (size_t i = 0; i < values.size(); ++i)
+        if (plane.at(i) != values[i]) return false;
+    uint16_t block[DeltaPlane::BLOCK];
+    for (size_t b = 0; b * DeltaPlane::BLOCK < values.size(); ++b) {
+        size_t n = plane.decodeBlock(b, block);
+        if (n != std::min(DeltaPlane::BLOCK, values.size() - b * DeltaPlane::BLOCK)) return false;
+        if (!std::equal(block, block + n, values.begin() + (std::ptrdiff_t)(b * DeltaPlane::BLOCK))) return false;
+    }
+    return true;
+}
+
+// Parents as the flight grid writes them: nondecreasing with small steps.
+static std::vector<uint16_t> nearlySorted(size_t n, uint32_t maxStep) {
+    std::vector<uint16_t> v(n);
+    uint32_t p = next() % 100;
+    for (auto& x : v) {
+        p += next() % (maxStep + 1);
+        x = (uint16_t)std::min<uint32_t>(p, 65535);
+    }
+    return v;
+}
+
+int main() {
+    CHECK(roundTrip({}));
+    CHECK(roundTrip({7}));
+    CHECK(roundTrip({65535}));
+
+    // Equal deltas pack to zero bits, including negative and wrapping ones.
+    std::vector<uint16_t> v;
+    for (int i = 0; i < 200; ++i) v.push_back(5);
+    CHECK(roundTrip(v));
+    v.clear();
+    for (int i = 0; i < 200; ++i) v.push_back((uint16_t)(60000 - 3 * i));
+    CHECK(roundTrip(v));
+
+    // Block edges: lengths around multiples of BLOCK.
+    for (size_t n : {DeltaPlane::BLOCK - 1, DeltaPlane::BLOCK, DeltaPlane::BLOCK + 1, 3 * DeltaPlane::BLOCK + 17})
+        CHECK(roundTrip(nearlySorted(n, 3)));
+
+    // Every packed width from 1 to 16 bits, so deltas straddle 64-bit words at every
+    // offset.
+    for (uint32_t bits = 1; bits <= 16; ++bits) {
+        v.assign(1000, 0);
+        for (auto& x : v) x = (uint16_t)(next() & ((1u << bits) - 1));
+        CHECK(roundTrip(v));
+    }
+
+    // Deltas beyond 16 bits: the full range swinging both ways needs 17, and one far
+    // outlier in a block of small steps widens only that block.
+    v.clear();
+    for (int i = 0; i < 300; ++i) v.push_back(i % 2 ? 65535 : 0);
+    CHECK(roundTrip(v));
+    v = nearlySorted(1000, 2);
+    v[500] = 65535;
+    v[501] = 0;
+    CHECK(roundTrip(v));
+    for (int i = 0; i < 20; ++i) {
+        v.assign(1 + next() % 3000, 0);
+        for (auto& x : v) x = (uint16_t)next();
+        CHECK(roundTrip(v));
+    }
+
+    // Nearly sorted parents are what the plane is for: they must shrink.
+    std::vector<uint16_t> parents = nearlySorted(20000, 3);
+    DeltaPlane plane(parents);
+    CHECK(roundTrip(parents));
+    CHECK(plane.bytes() * 4 < parents.size() * sizeof(uint16_t));
+
+    // Encoding again replaces the old contents.
+    plane.encode(v.data(), v.size());
+    CHECK(plane.size() == v.size() && plane.at(v.size() - 1) == v.back());
+
+    return test::testResult();
+}
@@ -0,0 +1,48 @@
+// tests/FeasibilityTest.cpp
+// AutomaticMacroMaker - the scan stops only at unsupported objects the player can reach
+// Developer: entity12208
+
+#include "Collision.hpp"
+#include "Feasibility.hpp"
+#include "TestUtil.hpp"
+
+using namespace amm;
+
+static Feasibility scan(const LevelSnapshot& level, const std::vector<UnsupportedObject>& unsupported) {
+    Broadphase broadphase;
+    broadphase.build(level);
+    return scanFeasibility(level, broadphase, 1.0f / 60.0f, unsupported);
+}
+
+int main() {
+    // A flat cube level under a low ceiling: the player stays below y 180.
+    LevelSnapshot level;
+    level.sections.push_back({0.0f, Gamemode::Cube, 311.58f, 90.0f, 180.0f, -1});
+    level.endX = 3000.0f;
+
+    CHECK(scan(level, {}).feasible);
+
+    // Far above the ceiling: no path touches it.
+    UnsupportedObject above{1500.0f, 5000.0f, 15.0f, 15.0f, "mini portal"};
+    CHECK(scan(level, {above}).feasible);
+
+    // On the floor: every path runs into it.
+    UnsupportedObject floor{1500.0f, 105.0f, 15.0f, 15.0f, "mini portal"};
+    Feasibility f = scan(level, {above, floor});
+    CHECK(!f.feasible);
+    CHECK(f.x == 1500.0f);
+    CHECK(f.reason == "unsupported mini portal");
+
+    // A trigger fired by X reaches every height.
+    UnsupportedObject trigger{800.0f, 5000.0f, 0.0f, std::numeric_limits<float>::infinity(), "gravity trigger"};
+    f = scan(level, {floor, trigger});
+    CHECK(!f.feasible);
+    CHECK(f.x == 800.0f);
+
+    // Behind the start, or past the end.
+    level.startX = 1000.0f;
+    CHECK(scan(level, {trigger}).feasible);
+    CHECK(scan(level, {UnsupportedObject{3500.0f, 105.0f, 15.0f, 15.0f, "dash orb"}}).feasible);
+
+    return test::testResult();
+}
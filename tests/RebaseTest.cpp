@@ -0,0 +1,64 @@
+// tests/RebaseTest.cpp
+// AutomaticMacroMaker - rebase() removes switched-off shapes instead of moving them away
+// Developer: entity12208
+
+#include "Collision.hpp"
+#include "CompiledLevel.hpp"
+#include "HazardRaster.hpp"
+#include "Physics.hpp"
+#include "TestUtil.hpp"
+
+using namespace amm;
+
+int main() {
+    CompiledLevel compiled;
+    compiled.level = test::contactLevel(100, 90.0f, 1);
+    LevelSnapshot& level = compiled.level;
+
+    // Object 0 (box 5 and the triangle) is switched off, object 1 (box 7) turns and
+    // object 2 (the circle, at x 420) moves.
+    compiled.dynamic = {{ShapeFamily::Box, 5, 0}, {ShapeFamily::Triangle, 0, 0},
+                        {ShapeFamily::Box, 7, 1}, {ShapeFamily::Circle, 0, 2}};
+    compiled.compiledPose = {{0.0f, 0.0f, 0.0f, true}, {945.0f, 165.0f, 0.0f, true}, {420.0f, 200.0f, 0.0f, true}};
+    std::vector<ObjectPose> live = {{0.0f, 0.0f, 0.0f, false}, {945.0f, 165.0f, 30.0f, true},
+                                    {480.0f, 200.0f, 0.0f, true}};
+    LiveStart start;
+    start.x = 0.0f;
+    RebaseStats stats;
+    LevelSnapshot rebased = rebase(compiled, live, start, &stats);
+
+    CHECK(stats.disabled == 2);
+    CHECK(stats.rotated == 1);
+    CHECK(rebased.boxes.size() == 98);
+    CHECK(rebased.orientedBoxes.size() == 2);
+    CHECK(rebased.triangles.size() == 0);
+    CHECK(rebased.circles.size() == 1 && rebased.circles.cx[0] == 480.0f);
+    for (size_t i = 0; i < rebased.boxes.size(); ++i) CHECK(rebased.boxes.minX[i] >= 300.0f);
+
+    Broadphase broadphase;
+    broadphase.build(rebased);
+    CHECK(broadphase.originX() >= 0.0f);
+    CHECK(broadphase.columnCount() < 200);
+    HazardRaster raster;
+    raster.build(rebased);
+    CHECK(raster.columns() < 400);
+
+    // The memo must answer exactly what the direct query does.
+    CHECK(test::memoMismatches(rebased, broadphase, 250.0f, 9550.0f, 200000) == 0);
+
+    // Rebasing past a portal keeps the passed sections, so section indices (and the
+    // entry states a kept SectionCache is keyed by) mean the same from any start.
+    level.sections.push_back({3000.0f, Gamemode::Ship, 311.58f, 90.0f, 390.0f, -1});
+    level.sections.push_back({6000.0f, Gamemode::Cube, 311.58f, 90.0f, 1.0e6f, 1});
+    start.x = 6500.0f;
+    start.known = true;
+    start.mode = Gamemode::Ball;
+    LevelSnapshot later = rebase(compiled, live, start);
+    CHECK(later.sections.size() == 3);
+    CHECK(later.sectionAt(later.startX) == 2);
+    CHECK(later.sections[1].startX == 3000.0f && later.sections[1].mode == Gamemode::Ship);
+    CHECK(later.sections[2].mode == Gamemode::Ball && later.sections[2].setGravity == -1);
+    CHECK(initialState(later).section == 2);
+
+    return test::testResult();
+}
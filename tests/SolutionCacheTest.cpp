@@ -0,0 +1,57 @@
+// tests/SolutionCacheTest.cpp
+// AutomaticMacroMaker - offer() keeps the cached entry that covers the most of the level
+// Developer: entity12208
+
+#include "SolutionCache.hpp"
+#include "TestUtil.hpp"
+
+#include <filesystem>
+
+using namespace amm;
+
+static CorpusEntry entry(float startX, bool solved) {
+    CorpusEntry e;
+    e.level.sections.push_back({0.0f, Gamemode::Cube, 311.58f, 90.0f, 1.0e6f, -1});
+    e.level.startX = startX;
+    e.level.endX = 1000.0f;
+    e.solved = solved;
+    if (solved) e.solution = Timeline(10, 1);
+    return e;
+}
+
+static float cachedStart(const SolutionCache& cache, bool& solved) {
+    CorpusEntry e;
+    solved = false;
+    if (!cache.load(1, e)) return -1.0f;
+    solved = e.solved;
+    return e.level.startX;
+}
+
+int main() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "amm-solution-cache-test";
+    std::filesystem::remove_all(dir);
+    SolutionCache cache;
+    CHECK(cache.open(dir));
+    bool solved = false;
+
+    // A failure is stored, and replaced by another failure or by a solution.
+    CHECK(cache.offer(1, entry(300.0f, false)));
+    CHECK(cachedStart(cache, solved) == 300.0f && !solved);
+    CHECK(cache.offer(1, entry(200.0f, false)));
+    CHECK(cachedStart(cache, solved) == 200.0f && !solved);
+    CHECK(cache.offer(1, entry(500.0f, true)));
+    CHECK(cachedStart(cache, solved) == 500.0f && solved);
+
+    // A solved entry survives failures and solutions from the same or a later start.
+    CHECK(cache.offer(1, entry(0.0f, false)));
+    CHECK(cache.offer(1, entry(500.0f, true)));
+    CHECK(cache.offer(1, entry(800.0f, true)));
+    CHECK(cachedStart(cache, solved) == 500.0f && solved);
+
+    // A solution from an earlier start replaces it.
+    CHECK(cache.offer(1, entry(100.0f, true)));
+    CHECK(cachedStart(cache, solved) == 100.0f && solved);
+
+    std::filesystem::remove_all(dir);
+    return test::testResult();
+}
@@ -0,0 +1,79 @@
+// tests/TestUtil.hpp
+// AutomaticMacroMaker - checks and level builders shared by the tests
+// Developer: entity12208
+//
+// Each test is a plain program: CHECK() reports a failed condition and keeps going, and
+// main() returns testResult() so ctest sees whether any check failed.
+
+#pragma once
+
+#include "Collision.hpp"
+#include "LevelSnapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace amm::test {
+
+inline int failures = 0;
+
+inline int testResult() {
+    if (failures) std::fprintf(stderr, "%d checks failed\n", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// A cube level up to x 9500 with `boxes` boxes every `spacing` units from x 300 (every
+// third a hazard, heights and widths varying so some abut or overlap), and `extras`
+// groups of one triangle, circle and oriented box each, 230 units apart from x 320.
+inline LevelSnapshot contactLevel(int boxes, float spacing, int extras) {
+    LevelSnapshot level;
+    for (int i = 0; i < boxes; ++i) {
+        float x = 300.0f + spacing * (float)i, y = 90.0f + 15.0f * (float)(i % 7);
+        level.boxes.add(x, y, x + 30.0f + (float)(i % 3), y + 30.0f, i % 3 == 0 ? HitKind::Hazard : HitKind::Solid);
+    }
+    for (int i = 0; i < extras; ++i) {
+        float x = 320.0f + 230.0f * (float)i;
+        level.triangles.add(x, 150.0f, x + 30.0f, 150.0f, x + 15.0f, 180.0f, HitKind::Hazard);
+        level.circles.add(x + 100.0f, 200.0f, 20.0f, HitKind::Hazard);
+        level.orientedBoxes.add(x + 60.0f, 250.0f, 20.0f, 5.0f, 0.8f, 0.6f, HitKind::Hazard);
+    }
+    level.sections.push_back({-1.0e30f, Gamemode::Cube, 311.58f, 90.0f, 1.0e6f, -1});
+    level.endX = 9500.0f;
+    return level;
+}
+
+inline bool sameContacts(const ShapeList& a, const ShapeList& b) {
+    return a.boxes == b.boxes && a.orientedBoxes == b.orientedBoxes && a.triangles == b.triangles &&
+        a.circles == b.circles;
+}
+
+// Random player boxes over [x0, x1) on which the collision memo and the direct query
+// disagree; the memo must answer exactly what findContacts does.
+inline size_t memoMismatches(const LevelSnapshot& level, const Broadphase& broadphase, float x0, float x1, int n) {
+    ShapeList candidates, direct, memo;
+    uint64_t rng = 12345;
+    size_t bad = 0;
+    for (int i = 0; i < n; ++i) {
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        float x = x0 + (x1 - x0) * (float)((rng >> 33) % 1000000) / 1.0e6f;
+        float y = 80.0f + (float)((rng >> 13) % 20000) / 100.0f;
+        float half = (rng & 3) == 0 ? 5.0f : (rng & 1) ? 15.0f : 12.0f;
+        Aabb player{x - half, y - half, x + half, y + half};
+        findContacts(level, broadphase, player, candidates, direct);
+        findPlayerContacts(level, broadphase, player, half, candidates, memo);
+        if (!sameContacts(direct, memo)) bad++;
+    }
+    return bad;
+}
+
+} // namespace amm::test
+
+#define CHECK(cond)                                                                           \
+    do {                                                                                      \
+        if (!(cond)) {                                                                        \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            amm::test::failures++;                                                            \
+        }                                                                                     \
+    } while (0)